@@ -0,0 +1,184 @@
+// Breadth-first search over a CSR view
+//
+// Direction-optimising BFS (Beamer, Asanovic and Patterson, SC'12).  Small
+// frontiers are expanded top-down from a queue, claiming each new vertex with
+// a compare-and-swap on its parent.  Once the frontier's edges outweigh the
+// unexplored ones, levels run bottom-up instead: every unvisited vertex scans
+// its own neighbours for one in the frontier bitmap and stops at the first hit.
+#include "BFS.h"
+#include "Parallel.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALPHA        15      // go bottom-up once frontier edges > unexplored / ALPHA
+#define BETA         18      // go top-down once the frontier < nV / BETA vertices
+#define CHUNK        256     // frontier entries per top-down step
+#define WORD_CHUNK   16      // bitmap words per bottom-up step
+#define LOCAL_QUEUE  512     // vertices buffered per thread before publishing
+#define PAD          (64 / sizeof(long))
+
+typedef struct {
+   CSR      *g;
+   Vertex   *parent;
+   int      *level;
+   int       depth;          // level being discovered
+   Vertex   *queue;          // top-down: current frontier
+   Vertex   *next;           // top-down: next frontier
+   long      nNext;          // #entries published to next
+   uint64_t *front;          // bottom-up: current frontier bitmap
+   uint64_t *nextBits;       // bottom-up: next frontier bitmap
+   long     *found;          // per thread: #vertices discovered
+   long     *edges;          // per thread: sum of their degrees
+} Search;
+
+static long degreeOf(CSR *g, Vertex v) {
+   return g->offsets[v + 1] - g->offsets[v];
+}
+
+static void publish(Search *s, Vertex *buf, int n) {
+   long at = __atomic_fetch_add(&s->nNext, n, __ATOMIC_RELAXED);
+   memcpy(s->next + at, buf, n * sizeof(Vertex));
+}
+
+static void topDown(int lo, int hi, int thread, void *arg) {
+   Search *s = arg;
+   CSR *g = s->g;
+   Vertex buf[LOCAL_QUEUE];
+   int n = 0;
+   long found = 0, edges = 0;
+
+   for (int i = lo; i < hi; i++) {
+      Vertex v = s->queue[i];
+      for (long k = g->offsets[v]; k < g->offsets[v + 1]; k++) {
+         Vertex w = g->targets[k];
+         Vertex unseen = -1;
+         if (__atomic_load_n(&s->parent[w], __ATOMIC_RELAXED) == -1
+             && __atomic_compare_exchange_n(&s->parent[w], &unseen, v, false,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            s->level[w] = s->depth;
+            found++;
+            edges += degreeOf(g, w);
+            buf[n++] = w;
+            if (n == LOCAL_QUEUE) {
+               publish(s, buf, n);
+               n = 0;
+            }
+         }
+      }
+   }
+   publish(s, buf, n);
+   s->found[thread * PAD] += found;
+   s->edges[thread * PAD] += edges;
+}
+
+// each step owns whole words of nextBits, so no atomics are needed
+static void bottomUp(int lo, int hi, int thread, void *arg) {
+   Search *s = arg;
+   CSR *g = s->g;
+   long found = 0, edges = 0;
+
+   for (int word = lo; word < hi; word++) {
+      uint64_t bits = 0;
+      Vertex end = (word + 1) * 64 < g->nV ? (word + 1) * 64 : g->nV;
+      for (Vertex v = word * 64; v < end; v++) {
+         if (s->parent[v] != -1)
+            continue;
+         for (long k = g->offsets[v]; k < g->offsets[v + 1]; k++) {
+            Vertex u = g->targets[k];
+            if (s->front[u / 64] >> (u % 64) & 1) {
+               s->parent[v] = u;
+               s->level[v] = s->depth;
+               bits |= 1ULL << (v % 64);
+               found++;
+               edges += degreeOf(g, v);
+               break;
+            }
+         }
+      }
+      s->nextBits[word] = bits;
+   }
+   s->found[thread * PAD] += found;
+   s->edges[thread * PAD] += edges;
+}
+
+// gather per-thread counters, resetting them for the next level
+static void collect(Search *s, int nThreads, long *found, long *edges) {
+   *found = *edges = 0;
+   for (int t = 0; t < nThreads; t++) {
+      *found += s->found[t * PAD];
+      *edges += s->edges[t * PAD];
+      s->found[t * PAD] = s->edges[t * PAD] = 0;
+   }
+}
+
+void bfs(CSR *g, Vertex src, int nThreads, int *level, Vertex *parent) {
+   assert(g != NULL && src >= 0 && src < g->nV);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+
+   int nV = g->nV;
+   size_t words = ((size_t)nV + 63) / 64;
+   Search s = { .g = g };
+   s.parent = parent != NULL ? parent : malloc(nV * sizeof(Vertex));
+   s.level = level != NULL ? level : malloc(nV * sizeof(int));
+   s.queue = malloc(nV * sizeof(Vertex));
+   s.next = malloc(nV * sizeof(Vertex));
+   s.front = calloc(words, sizeof(uint64_t));
+   s.nextBits = calloc(words, sizeof(uint64_t));
+   s.found = calloc(nThreads * PAD, sizeof(long));
+   s.edges = calloc(nThreads * PAD, sizeof(long));
+   assert(s.parent != NULL && s.level != NULL && s.queue != NULL && s.next != NULL
+          && s.front != NULL && s.nextBits != NULL && s.found != NULL && s.edges != NULL);
+
+   for (Vertex v = 0; v < nV; v++) {
+      s.parent[v] = -1;
+      s.level[v] = -1;
+   }
+   s.parent[src] = src;
+   s.level[src] = 0;
+   s.queue[0] = src;
+
+   long nFront = 1;                       // #vertices in the frontier
+   long frontEdges = degreeOf(g, src);    // sum of their degrees
+   long unexplored = g->nE - frontEdges;  // degrees of vertices not yet reached
+   bool bitmap = false;                   // frontier held in front, not queue
+
+   for (s.depth = 1; nFront > 0; s.depth++) {
+      if (!bitmap && frontEdges > unexplored / ALPHA) {
+         memset(s.front, 0, words * sizeof(uint64_t));
+         for (long i = 0; i < nFront; i++)
+            s.front[s.queue[i] / 64] |= 1ULL << (s.queue[i] % 64);
+         bitmap = true;
+      } else if (bitmap && nFront < nV / BETA) {
+         nFront = 0;
+         for (size_t w = 0; w < words; w++)
+            for (uint64_t m = s.front[w]; m != 0; m &= m - 1)
+               s.queue[nFront++] = w * 64 + __builtin_ctzll(m);
+         bitmap = false;
+      }
+
+      if (bitmap) {
+         parallelFor(words, WORD_CHUNK, nThreads, bottomUp, &s);
+         uint64_t *t = s.front; s.front = s.nextBits; s.nextBits = t;
+      } else {
+         s.nNext = 0;
+         parallelFor(nFront, CHUNK, nThreads, topDown, &s);
+         Vertex *t = s.queue; s.queue = s.next; s.next = t;
+      }
+      collect(&s, nThreads, &nFront, &frontEdges);
+      unexplored -= frontEdges;
+   }
+
+   if (parent == NULL)
+      free(s.parent);
+   if (level == NULL)
+      free(s.level);
+   free(s.queue);
+   free(s.next);
+   free(s.front);
+   free(s.nextBits);
+   free(s.found);
+   free(s.edges);
+}
@@ -0,0 +1,13 @@
+// Breadth-first search over a CSR view
+#ifndef BFS_H
+#define BFS_H
+
+#include "CSR.h"
+
+// hop distances from src: level[v] = #edges on a shortest path (-1 if
+// unreachable), parent[v] = previous vertex on one such path (src for src,
+// -1 if unreachable); either array may be NULL.  With several threads the
+// levels are fixed but which shortest-path parent is kept may vary.
+void bfs(CSR *, Vertex src, int nThreads, int *level, Vertex *parent);
+
+#endif
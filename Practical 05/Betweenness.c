@@ -0,0 +1,178 @@
+// Betweenness centrality over a CSR view
+//
+// Brandes' algorithm: a BFS from each source counts the shortest paths
+// sigma[v] to every vertex, then the vertices are revisited farthest first
+// and each takes delta[v] = sum of sigma[v] / sigma[w] * (1 + delta[w]) over
+// the neighbours w one level further out.  delta[v] is the source's
+// dependency on v and is added to v's score; (1 + delta[w]) / sigma[w] is
+// kept instead of delta[w] so the inner loop does not divide.  Sources are
+// spread over the threads; each thread owns its BFS arrays and its own score
+// array, and the score arrays are summed once all sources are done.
+#include "Betweenness.h"
+#include "Parallel.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define SOURCE_CHUNK 1       // sources claimed at a time, each a whole BFS
+#define VERTEX_CHUNK 4096    // vertices per step when summing the scores
+
+typedef struct {
+   int    *level;            // hops from the source, -1 if not reached
+   double *sigma;            // #shortest paths from the source
+   double *share;            // (1 + dependency of the source on v) / sigma[v]
+   Vertex *order;            // vertices in the order the BFS reached them
+   double *score;            // this thread's sum of dependencies
+} Scratch;
+
+typedef struct {
+   const CSR    *g;
+   const Vertex *sources;    // NULL: every vertex
+   Scratch      *scratch;    // per thread
+   int           nThreads;
+   double        scale;
+   double       *bc;
+} Brandes;
+
+static void fromSource(const CSR *g, Vertex s, Scratch *w) {
+   int n = 0;
+   w->level[s] = 0;
+   w->sigma[s] = 1;
+   w->order[n++] = s;
+   for (int head = 0; head < n; head++) {
+      Vertex v = w->order[head];
+      for (long i = g->offsets[v]; i < g->offsets[v + 1]; i++) {
+         Vertex u = g->targets[i];
+         if (w->level[u] < 0) {
+            w->level[u] = w->level[v] + 1;
+            w->sigma[u] = 0;
+            w->order[n++] = u;
+         }
+         if (w->level[u] == w->level[v] + 1)
+            w->sigma[u] += w->sigma[v];
+      }
+   }
+
+   // order[0] is s, which gets no score
+   for (int i = n - 1; i > 0; i--) {
+      Vertex v = w->order[i];
+      double d = 0;
+      for (long j = g->offsets[v]; j < g->offsets[v + 1]; j++) {
+         Vertex u = g->targets[j];
+         if (w->level[u] == w->level[v] + 1)
+            d += w->share[u];
+      }
+      double delta = w->sigma[v] * d;
+      w->score[v] += delta;
+      w->share[v] = (1 + delta) / w->sigma[v];
+   }
+   for (int i = 0; i < n; i++)
+      w->level[w->order[i]] = -1;
+}
+
+static void sourceRange(int lo, int hi, int thread, void *arg) {
+   Brandes *b = arg;
+   for (int i = lo; i < hi; i++)
+      fromSource(b->g, b->sources != NULL ? b->sources[i] : i, &b->scratch[thread]);
+}
+
+static void sumRange(int lo, int hi, int thread, void *arg) {
+   Brandes *b = arg;
+   for (Vertex v = lo; v < hi; v++) {
+      double s = 0;
+      for (int t = 0; t < b->nThreads; t++)
+         s += b->scratch[t].score[v];
+      b->bc[v] = s * b->scale;
+   }
+}
+
+// k distinct vertices: the first k of a partial Fisher-Yates shuffle
+static Vertex *drawSources(int nV, int k, unsigned seed) {
+   Vertex *all = malloc(nV * sizeof(Vertex));
+   assert(all != NULL);
+   for (Vertex v = 0; v < nV; v++)
+      all[v] = v;
+   uint32_t x = seed != 0 ? seed : 2463534242u;
+   for (int i = 0; i < k; i++) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      int j = i + (int)(x % (uint32_t)(nV - i));
+      Vertex t = all[i];
+      all[i] = all[j];
+      all[j] = t;
+   }
+   return all;
+}
+
+void betweenness(CSR *g, int samples, unsigned seed, int nThreads, double *bc) {
+   assert(g != NULL && bc != NULL);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+   int nV = g->nV;
+   bool sampled = samples > 0 && samples < nV;
+   int nSources = sampled ? samples : nV;
+
+   Brandes b = { .g = g, .nThreads = nThreads, .bc = bc };
+   b.sources = sampled ? drawSources(nV, samples, seed) : NULL;
+   b.scale = 0.5 * nV / (nSources > 0 ? nSources : 1);   // undirected: each pair from both ends
+   b.scratch = malloc(nThreads * sizeof(Scratch));
+   assert(b.scratch != NULL);
+   for (int t = 0; t < nThreads; t++) {
+      Scratch *w = &b.scratch[t];
+      w->level = malloc((nV > 0 ? nV : 1) * sizeof(int));
+      w->sigma = malloc((nV > 0 ? nV : 1) * sizeof(double));
+      w->share = malloc((nV > 0 ? nV : 1) * sizeof(double));
+      w->order = malloc((nV > 0 ? nV : 1) * sizeof(Vertex));
+      w->score = calloc(nV > 0 ? nV : 1, sizeof(double));
+      assert(w->level != NULL && w->sigma != NULL && w->share != NULL
+             && w->order != NULL && w->score != NULL);
+      for (Vertex v = 0; v < nV; v++)
+         w->level[v] = -1;
+   }
+
+   parallelFor(nSources, SOURCE_CHUNK, nThreads, sourceRange, &b);
+   parallelFor(nV, VERTEX_CHUNK, nThreads, sumRange, &b);
+
+   for (int t = 0; t < nThreads; t++) {
+      free(b.scratch[t].level);
+      free(b.scratch[t].sigma);
+      free(b.scratch[t].share);
+      free(b.scratch[t].order);
+      free(b.scratch[t].score);
+   }
+   free(b.scratch);
+   free((Vertex *)b.sources);
+}
+
+/* ---------- top k ---------- */
+
+typedef struct {
+   double bc;
+   Vertex v;
+} Ranked;
+
+static int byScore(const void *a, const void *b) {
+   const Ranked *x = a, *y = b;
+   if (x->bc != y->bc)
+      return x->bc > y->bc ? -1 : 1;
+   return (x->v > y->v) - (x->v < y->v);
+}
+
+int topBetweenness(const double *bc, int nV, int k, Vertex *top) {
+   assert(bc != NULL && top != NULL);
+   if (k > nV)
+      k = nV;
+   if (k <= 0)
+      return 0;
+   Ranked *r = malloc(nV * sizeof(Ranked));
+   assert(r != NULL);
+   for (Vertex v = 0; v < nV; v++)
+      r[v] = (Ranked){ bc[v], v };
+   qsort(r, nV, sizeof(Ranked), byScore);
+   for (int i = 0; i < k; i++)
+      top[i] = r[i].v;
+   free(r);
+   return k;
+}
@@ -0,0 +1,18 @@
+// Betweenness centrality over a CSR view
+#ifndef BETWEENNESS_H
+#define BETWEENNESS_H
+
+#include "CSR.h"
+
+// bc[v] = sum over pairs {s, t} of the share of shortest s-t paths that run
+// through v (v != s, t), each unordered pair counted once.  With 0 < samples
+// < nV it is estimated from that many distinct sources drawn from seed and
+// scaled by nV / samples; otherwise every vertex is a source.  Sources run
+// in parallel, so the last bits may differ between thread counts.
+void betweenness(CSR *, int samples, unsigned seed, int nThreads, double *bc);
+
+// the min(k, nV) vertices of highest bc into top[], highest first and ties
+// to the lower vertex; returns how many
+int topBetweenness(const double *bc, int nV, int k, Vertex *top);
+
+#endif
@@ -0,0 +1,114 @@
+// Compressed sparse row view of a Graph
+#include "CSR.h"
+#include <assert.h>
+#include <stdlib.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define GALLOP_RATIO 32   // gallop when one list is this much longer
+
+CSR *newCSR(Graph g) {
+   assert(g != NULL);
+   int nV = numOfVertices(g);
+
+   CSR *c = malloc(sizeof(CSR));
+   assert(c != NULL);
+   c->nV = nV;
+   c->offsets = malloc((nV + 1) * sizeof(long));
+   assert(c->offsets != NULL);
+
+   // row sizes come straight from the maintained degrees
+   c->offsets[0] = 0;
+   for (Vertex v = 0; v < nV; v++)
+      c->offsets[v + 1] = c->offsets[v] + degree(g, v);
+   c->nE = c->offsets[nV];
+
+   c->targets = malloc((c->nE > 0 ? c->nE : 1) * sizeof(Vertex));
+   assert(c->targets != NULL);
+   for (Vertex v = 0; v < nV; v++) {
+      long i = c->offsets[v];
+      for (Vertex w = firstNeighbour(g, v); w != -1; w = nextNeighbour(g, v, w))
+         c->targets[i++] = w;
+   }
+   return c;
+}
+
+void freeCSR(CSR *c) {
+   assert(c != NULL);
+   free(c->offsets);
+   free(c->targets);
+   free(c);
+}
+
+long lowerBoundRow(const Vertex *a, long lo, long n, Vertex x) {
+   long step = 1;
+   while (lo + step < n && a[lo + step] < x)   // gallop, then bisect
+      step *= 2;
+   long hi = lo + step < n ? lo + step : n;
+   lo += step / 2;
+   while (lo < hi) {
+      long mid = lo + (hi - lo) / 2;
+      if (a[mid] < x)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+long intersectRows(const Vertex *a, long na, const Vertex *b, long nb, Vertex *out) {
+   if (na > nb) {
+      const Vertex *t = a; a = b; b = t;
+      long tn = na; na = nb; nb = tn;
+   }
+   long c = 0;
+   if (nb > GALLOP_RATIO * na) {
+      long j = 0;
+      for (long i = 0; i < na && j < nb; i++) {
+         j = lowerBoundRow(b, j, nb, a[i]);
+         if (j < nb && b[j] == a[i]) {
+            if (out != NULL)
+               out[c] = a[i];
+            c++;
+         }
+      }
+      return c;
+   }
+
+   long i = 0, j = 0;
+#ifdef __AVX2__
+   // compare 8 of a against every rotation of 8 of b; drop the block with the smaller tail
+   const __m256i rot = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+   while (i + 8 <= na && j + 8 <= nb) {
+      __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+      __m256i vb = _mm256_loadu_si256((const __m256i *)(b + j));
+      __m256i eq = _mm256_cmpeq_epi32(va, vb);
+      for (int r = 1; r < 8; r++) {
+         vb = _mm256_permutevar8x32_epi32(vb, rot);
+         eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+      }
+      unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+      if (out != NULL) {
+         for (unsigned m = mask; m != 0; m &= m - 1)
+            out[c++] = a[i + __builtin_ctz(m)];
+      } else {
+         c += __builtin_popcount(mask);
+      }
+      Vertex amax = a[i + 7], bmax = b[j + 7];
+      i += amax <= bmax ? 8 : 0;
+      j += bmax <= amax ? 8 : 0;
+   }
+#endif
+   while (i < na && j < nb) {
+      if (a[i] == b[j]) {
+         if (out != NULL)
+            out[c] = a[i];
+         c++;
+      }
+      Vertex x = a[i], y = b[j];
+      i += x <= y;
+      j += y <= x;
+   }
+   return c;
+}
@@ -0,0 +1,24 @@
+// Compressed sparse row view of a Graph
+#ifndef CSR_H
+#define CSR_H
+
+#include "Graph.h"
+
+typedef struct CSR {
+   int     nV;        // #vertices
+   long    nE;        // #adjacency entries (each edge twice, a loop once)
+   long   *offsets;   // neighbours of v: targets[offsets[v] .. offsets[v+1]-1]
+   Vertex *targets;   // ascending within each row
+} CSR;
+
+CSR *newCSR(Graph);   // snapshot of the graph's current edges
+void freeCSR(CSR *);
+
+// first index i in lo..n-1 with a[i] >= x (n if none); a ascending
+long lowerBoundRow(const Vertex *a, long lo, long n, Vertex x);
+
+// #elements common to ascending lists a and b, written to out unless NULL;
+// gallops when one list is much longer, compares 8x8 blocks with AVX2
+long intersectRows(const Vertex *a, long na, const Vertex *b, long nb, Vertex *out);
+
+#endif
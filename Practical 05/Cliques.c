@@ -0,0 +1,394 @@
+// Clique enumeration: maximal cliques (Bron-Kerbosch) and k-cliques
+//
+// Both enumerators follow a degeneracy ordering: each clique is found from its
+// earliest vertex v, whose later neighbours P number at most the degeneracy d.
+// The search below v runs on bitsets local to N(v): candidates P live in a
+// P-universe of |P| <= d bits and the excluded set X in a P-universe part
+// (vertices moved out of P) plus an X-universe of earlier neighbours of v
+// that touch P, so every set operation is a word-parallel AND over small rows.
+// Top-level vertices are independent and are spread across threads.
+#define _POSIX_C_SOURCE 200809L
+#include "Cliques.h"
+#include "Parallel.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHUNK 8                 // top-level vertices claimed at a time
+
+#define WORDS(n)   (((size_t)(n) + 63) / 64)
+#define HAS(s, i)  (((s)[(i) / 64] >> ((i) % 64)) & 1)
+#define ADD(s, i)  ((s)[(i) / 64] |= 1ULL << ((i) % 64))
+#define DEL(s, i)  ((s)[(i) / 64] &= ~(1ULL << ((i) % 64)))
+
+/* ---------- degeneracy ordering ---------- */
+
+// Batagelj-Zaversnik bucket peeling; pos[v] = place of v in the ordering
+static void degeneracyOrder(CSR *g, int *pos) {
+   int nV = g->nV, maxDeg = 0;
+   int *deg = malloc((nV > 0 ? nV : 1) * sizeof(int));
+   Vertex *vert = malloc((nV > 0 ? nV : 1) * sizeof(Vertex));
+   assert(deg != NULL && vert != NULL);
+   for (Vertex v = 0; v < nV; v++) {
+      deg[v] = 0;
+      for (long i = g->offsets[v]; i < g->offsets[v + 1]; i++)
+         deg[v] += g->targets[i] != v;
+      if (deg[v] > maxDeg)
+         maxDeg = deg[v];
+   }
+   int *bin = calloc(maxDeg + 1, sizeof(int));
+   assert(bin != NULL);
+   for (Vertex v = 0; v < nV; v++)
+      bin[deg[v]]++;
+   for (int d = 0, start = 0; d <= maxDeg; d++) {
+      int n = bin[d];
+      bin[d] = start;
+      start += n;
+   }
+   for (Vertex v = 0; v < nV; v++) {
+      pos[v] = bin[deg[v]]++;
+      vert[pos[v]] = v;
+   }
+   for (int d = maxDeg; d > 0; d--)
+      bin[d] = bin[d - 1];
+   bin[0] = 0;
+
+   // repeatedly remove a vertex of minimum remaining degree
+   for (int i = 0; i < nV; i++) {
+      Vertex v = vert[i];
+      for (long k = g->offsets[v]; k < g->offsets[v + 1]; k++) {
+         Vertex u = g->targets[k];
+         if (u != v && deg[u] > deg[v]) {
+            int du = deg[u], pu = pos[u], pw = bin[du];
+            Vertex w = vert[pw];
+            if (u != w) {
+               pos[u] = pw; vert[pw] = u;
+               pos[w] = pu; vert[pu] = w;
+            }
+            bin[du]++;
+            deg[u]--;
+         }
+      }
+   }
+   free(deg);
+   free(vert);
+   free(bin);
+}
+
+/* ---------- neighbourhood of a top-level vertex ---------- */
+
+typedef struct {
+   int      *local;     // vertex -> local index (-1 outside N(v), -2 unused earlier neighbour)
+   Vertex   *P, *X;     // local index -> vertex for each universe
+   Vertex   *common;    // intersection buffer
+   int       p, x;      // universe sizes
+   bool      earlier;   // v has an earlier neighbour at all
+   size_t    pw, xw;    // words per P / X set
+   uint64_t *NP;        // (p + x) rows of pw words: neighbours in P
+   uint64_t *NX;        // p rows of xw words: neighbours in X
+   uint64_t *sets;      // per-depth sets used by the search
+   Vertex   *R;         // current clique
+   Vertex   *buf;       // storage behind P, X, common and R
+   size_t    capV, capNP, capNX, capSets;   // capacities, in elements
+   long      count;     // cliques found by this thread
+} Workspace;
+
+typedef struct {
+   CSR            *g;
+   int            *pos;
+   int             k;
+   CliqueFn        visit;
+   void           *arg;
+   pthread_mutex_t lock;
+   Workspace      *ws;      // one per thread
+} Job;
+
+static void *grow(void *p, size_t *cap, size_t need, size_t size) {
+   if (need <= *cap)
+      return p;
+   *cap = need * 2;
+   p = realloc(p, *cap * size);
+   assert(p != NULL);
+   return p;
+}
+
+// build P (later neighbours) and, if withX, X (earlier neighbours adjacent to P)
+static void loadNeighbourhood(Job *job, Workspace *w, Vertex v, bool withX) {
+   CSR *g = job->g;
+   const Vertex *nv = g->targets + g->offsets[v];
+   long dv = g->offsets[v + 1] - g->offsets[v];
+
+   // P, X, common and R each hold at most dv + 1 vertices
+   w->buf = grow(w->buf, &w->capV, 4 * (dv + 8), sizeof(Vertex));
+   w->P = w->buf;
+   w->X = w->P + dv + 8;
+   w->common = w->X + dv + 8;
+   w->R = w->common + dv + 8;
+
+   w->p = w->x = 0;
+   w->earlier = false;
+   for (long i = 0; i < dv; i++) {
+      Vertex u = nv[i];
+      if (u == v)
+         continue;
+      if (job->pos[u] > job->pos[v]) {
+         w->local[u] = w->p;
+         w->P[w->p++] = u;
+      } else {
+         w->local[u] = -2;
+         w->earlier = true;
+      }
+   }
+
+   // an earlier neighbour matters only if some candidate is adjacent to it
+   if (withX) {
+      for (int i = 0; i < w->p; i++) {
+         Vertex u = w->P[i];
+         long c = intersectRows(nv, dv, g->targets + g->offsets[u],
+                                g->offsets[u + 1] - g->offsets[u], w->common);
+         for (long k = 0; k < c; k++)
+            if (w->local[w->common[k]] == -2) {
+               w->local[w->common[k]] = w->p + w->x;
+               w->X[w->x++] = w->common[k];
+            }
+      }
+   }
+
+   w->pw = WORDS(w->p);
+   w->xw = WORDS(w->x);
+   w->NP = grow(w->NP, &w->capNP, (w->p + w->x) * w->pw + 1, sizeof(uint64_t));
+   w->NX = grow(w->NX, &w->capNX, w->p * w->xw + 1, sizeof(uint64_t));
+   memset(w->NP, 0, (w->p + w->x) * w->pw * sizeof(uint64_t));
+   memset(w->NX, 0, w->p * w->xw * sizeof(uint64_t));
+
+   for (int i = 0; i < w->p; i++) {
+      Vertex u = w->P[i];
+      long c = intersectRows(nv, dv, g->targets + g->offsets[u],
+                             g->offsets[u + 1] - g->offsets[u], w->common);
+      for (long k = 0; k < c; k++) {
+         int j = w->local[w->common[k]];
+         if (j >= 0 && j < w->p) {
+            if (j != i)                   // a loop at u is not an edge of a clique
+               ADD(w->NP + i * w->pw, j);
+         } else if (j >= w->p) {
+            ADD(w->NX + i * w->xw, j - w->p);
+            ADD(w->NP + j * w->pw, i);
+         }
+      }
+   }
+
+   // per-depth sets: P, XP, XX and the branch candidates
+   size_t need = (size_t)(w->p + 2) * (3 * w->pw + w->xw) + 1;
+   w->sets = grow(w->sets, &w->capSets, need, sizeof(uint64_t));
+}
+
+static void clearNeighbourhood(Job *job, Workspace *w, Vertex v) {
+   CSR *g = job->g;
+   for (long i = g->offsets[v]; i < g->offsets[v + 1]; i++)
+      w->local[g->targets[i]] = -1;
+}
+
+static int cmpVertex(const void *a, const void *b) {
+   Vertex x = *(const Vertex *)a, y = *(const Vertex *)b;
+   return (x > y) - (x < y);
+}
+
+// R[0] is a vertex, R[1..size-1] local P indices
+static void report(Job *job, Workspace *w, int size) {
+   w->count++;
+   if (job->visit == NULL)
+      return;
+   Vertex clique[size];
+   clique[0] = w->R[0];
+   for (int i = 1; i < size; i++)
+      clique[i] = w->P[w->R[i]];
+   qsort(clique, size, sizeof(Vertex), cmpVertex);
+   pthread_mutex_lock(&job->lock);
+   job->visit(clique, size, job->arg);
+   pthread_mutex_unlock(&job->lock);
+}
+
+static int countBits(const uint64_t *s, size_t words) {
+   int c = 0;
+   for (size_t i = 0; i < words; i++)
+      c += __builtin_popcountll(s[i]);
+   return c;
+}
+
+static bool isEmpty(const uint64_t *s, size_t words) {
+   for (size_t i = 0; i < words; i++)
+      if (s[i] != 0)
+         return false;
+   return true;
+}
+
+/* ---------- Bron-Kerbosch with Tomita pivoting ---------- */
+
+static void expand(Job *job, Workspace *w, int depth, uint64_t *P, uint64_t *XP, uint64_t *XX) {
+   size_t pw = w->pw, xw = w->xw;
+   if (isEmpty(P, pw)) {
+      if (isEmpty(XP, pw) && isEmpty(XX, xw))
+         report(job, w, depth);
+      return;
+   }
+
+   // pivot: the vertex of P u X with most neighbours in P
+   int best = -1, bestCount = -1;
+   for (size_t i = 0; i < pw; i++)
+      for (uint64_t m = P[i] | XP[i]; m != 0; m &= m - 1) {
+         int u = i * 64 + __builtin_ctzll(m);
+         int c = 0;
+         for (size_t j = 0; j < pw; j++)
+            c += __builtin_popcountll(P[j] & w->NP[u * pw + j]);
+         if (c > bestCount) { best = u; bestCount = c; }
+      }
+   for (size_t i = 0; i < xw; i++)
+      for (uint64_t m = XX[i]; m != 0; m &= m - 1) {
+         int u = w->p + i * 64 + __builtin_ctzll(m);
+         int c = 0;
+         for (size_t j = 0; j < pw; j++)
+            c += __builtin_popcountll(P[j] & w->NP[u * pw + j]);
+         if (c > bestCount) { best = u; bestCount = c; }
+      }
+
+   uint64_t *next = XX + xw;              // this depth's sets follow the caller's
+   uint64_t *cand = next, *nP = cand + pw, *nXP = nP + pw, *nXX = nXP + pw;
+   for (size_t i = 0; i < pw; i++)
+      cand[i] = P[i] & ~w->NP[best * pw + i];
+
+   for (size_t i = 0; i < pw; i++)
+      for (uint64_t m = cand[i]; m != 0; m &= m - 1) {
+         int q = i * 64 + __builtin_ctzll(m);
+         const uint64_t *nq = w->NP + q * pw, *xq = w->NX + q * xw;
+         for (size_t j = 0; j < pw; j++) {
+            nP[j] = P[j] & nq[j];
+            nXP[j] = XP[j] & nq[j];
+         }
+         for (size_t j = 0; j < xw; j++)
+            nXX[j] = XX[j] & xq[j];
+         w->R[depth] = q;
+         expand(job, w, depth + 1, nP, nXP, nXX);
+         DEL(P, q);
+         ADD(XP, q);
+      }
+}
+
+static void maximalRange(int lo, int hi, int thread, void *arg) {
+   Job *job = arg;
+   Workspace *w = &job->ws[thread];
+   for (Vertex v = lo; v < hi; v++) {
+      loadNeighbourhood(job, w, v, true);
+      w->R[0] = v;
+      if (w->p == 0) {
+         if (!w->earlier)
+            report(job, w, 1);
+      } else {
+         uint64_t *P = w->sets, *XP = P + w->pw, *XX = XP + w->pw;
+         memset(P, 0, (2 * w->pw + w->xw) * sizeof(uint64_t));
+         for (int i = 0; i < w->p; i++)
+            ADD(P, i);
+         for (int i = 0; i < w->x; i++)
+            ADD(XX, i);
+         expand(job, w, 1, P, XP, XX);
+      }
+      clearNeighbourhood(job, w, v);
+   }
+}
+
+/* ---------- k-cliques ---------- */
+
+// extend R[0..depth-1] with later candidates from P until it has k vertices
+static void extend(Job *job, Workspace *w, int depth, const uint64_t *P) {
+   size_t pw = w->pw;
+   if (depth == job->k - 1 && job->visit == NULL) {
+      w->count += countBits(P, pw);
+      return;
+   }
+   if (depth + countBits(P, pw) < job->k)
+      return;
+
+   uint64_t *nP = (uint64_t *)P + pw;
+   for (size_t i = 0; i < pw; i++)
+      for (uint64_t m = P[i]; m != 0; m &= m - 1) {
+         int q = i * 64 + __builtin_ctzll(m);
+         w->R[depth] = q;
+         if (depth + 1 == job->k) {
+            report(job, w, job->k);
+            continue;
+         }
+         // keep only candidates after q so each clique is built once
+         const uint64_t *nq = w->NP + q * pw;
+         for (size_t j = 0; j < pw; j++)
+            nP[j] = j < (size_t)q / 64 ? 0 : P[j] & nq[j];
+         nP[q / 64] &= q % 64 == 63 ? 0 : ~0ULL << (q % 64 + 1);
+         extend(job, w, depth + 1, nP);
+      }
+}
+
+static void kRange(int lo, int hi, int thread, void *arg) {
+   Job *job = arg;
+   Workspace *w = &job->ws[thread];
+   for (Vertex v = lo; v < hi; v++) {
+      loadNeighbourhood(job, w, v, false);
+      w->R[0] = v;
+      if (job->k == 1) {
+         report(job, w, 1);
+      } else if (w->p >= job->k - 1) {
+         uint64_t *P = w->sets;
+         memset(P, 0, w->pw * sizeof(uint64_t));
+         for (int i = 0; i < w->p; i++)
+            ADD(P, i);
+         extend(job, w, 1, P);
+      }
+      clearNeighbourhood(job, w, v);
+   }
+}
+
+/* ---------- driver ---------- */
+
+static long run(CSR *g, int k, int nThreads, CliqueFn visit, void *arg, RangeFn body) {
+   assert(g != NULL);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+
+   Job job = { .g = g, .k = k, .visit = visit, .arg = arg };
+   pthread_mutex_init(&job.lock, NULL);
+   job.pos = malloc((g->nV > 0 ? g->nV : 1) * sizeof(int));
+   job.ws = calloc(nThreads, sizeof(Workspace));
+   assert(job.pos != NULL && job.ws != NULL);
+   degeneracyOrder(g, job.pos);
+   for (int t = 0; t < nThreads; t++) {
+      job.ws[t].local = malloc((g->nV > 0 ? g->nV : 1) * sizeof(int));
+      assert(job.ws[t].local != NULL);
+      for (Vertex v = 0; v < g->nV; v++)
+         job.ws[t].local[v] = -1;
+   }
+
+   parallelFor(g->nV, CHUNK, nThreads, body, &job);
+
+   long total = 0;
+   for (int t = 0; t < nThreads; t++) {
+      Workspace *w = &job.ws[t];
+      total += w->count;
+      free(w->local);
+      free(w->buf);
+      free(w->NP);
+      free(w->NX);
+      free(w->sets);
+   }
+   free(job.ws);
+   free(job.pos);
+   pthread_mutex_destroy(&job.lock);
+   return total;
+}
+
+long maximalCliques(CSR *g, int nThreads, CliqueFn visit, void *arg) {
+   return run(g, 0, nThreads, visit, arg, maximalRange);
+}
+
+long kCliques(CSR *g, int k, int nThreads, CliqueFn visit, void *arg) {
+   assert(k >= 1);
+   return run(g, k, nThreads, visit, arg, kRange);
+}
@@ -0,0 +1,17 @@
+// Clique enumeration: maximal cliques (Bron-Kerbosch) and k-cliques
+#ifndef CLIQUES_H
+#define CLIQUES_H
+
+#include "CSR.h"
+
+// called once per clique, vertices ascending; with several threads calls are
+// serialised but arrive in no particular order
+typedef void (*CliqueFn)(const Vertex *clique, int size, void *arg);
+
+// enumerate every maximal clique (loops ignored); visit may be NULL to count only
+long maximalCliques(CSR *, int nThreads, CliqueFn visit, void *arg);
+
+// enumerate every clique of exactly k vertices; visit may be NULL to count only
+long kCliques(CSR *, int k, int nThreads, CliqueFn visit, void *arg);
+
+#endif
@@ -0,0 +1,434 @@
+// Dynamic connectivity ADT
+// Holm, de Lichtenberg and Thorup (2001): O(log^2 n) amortised per update,
+// O(log n) per query
+//
+// Every edge has a level 0..log2 n.  Forest F_i spans the edges of level >= i
+// (so F_0 spans the graph) and every tree of F_i has at most n/2^i vertices.
+// Deleting a tree edge of level l searches levels l..0 for a replacement; the
+// smaller side's tree and non-tree edges that fail are pushed one level up,
+// which pays for the search.  Each tree of each F_i is an Euler tour kept in a
+// treap, so link, cut, reroot and "same tree?" are O(log n).
+#include "DynConn.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define TREE_FLAG    1   // arc of a tree edge whose level is this forest's level
+#define NONTREE_FLAG 2   // vertex with non-tree edges at this level
+
+typedef struct Edge Edge;
+
+// one entry of an Euler tour: a vertex occurrence or a directed arc
+typedef struct Node {
+   struct Node  *left, *right, *parent;
+   uint32_t      prio;       // treap heap order
+   int           size;       // #vertex nodes in subtree (tree size)
+   int           count;      // #nodes in subtree (tour positions)
+   unsigned char flag;       // own TREE_FLAG / NONTREE_FLAG
+   unsigned char agg;        // flags anywhere in subtree
+   int           vertex;     // vertex id, or -1 for an arc
+   Edge         *edge;       // edge of an arc
+   Edge        **adj;        // vertex node: non-tree edges at this level
+   int           nAdj, capAdj;
+} Node;
+
+struct Edge {
+   int    v, w;
+   int    level;
+   bool   tree;
+   int    posV, posW;        // non-tree: index in the adj lists of v and w
+   Node **arcs;              // tree: arcs[2i], arcs[2i+1] are its arcs in F_i
+   int    capArcs;
+};
+
+typedef struct DynConnRep {
+   int      nV;
+   Node  ***at;              // at[v][i] = node of v in F_i, NULL while v is alone
+   int     *nAt;             // #levels allocated in at[v]
+   Edge   **table;           // edges by endpoint pair (linear probing)
+   size_t   mask;            // table capacity - 1
+   size_t   nEdges;
+   uint32_t seed;            // xorshift state for treap priorities
+} DynConnRep;
+
+/* ---------- treap over Euler tours ---------- */
+
+static int sizeOf(Node *t)  { return t != NULL ? t->size : 0; }
+static int countOf(Node *t) { return t != NULL ? t->count : 0; }
+static int aggOf(Node *t)   { return t != NULL ? t->agg : 0; }
+
+static void update(Node *t) {
+   t->size = (t->vertex >= 0) + sizeOf(t->left) + sizeOf(t->right);
+   t->count = 1 + countOf(t->left) + countOf(t->right);
+   t->agg = t->flag | aggOf(t->left) | aggOf(t->right);
+}
+
+static Node *newNode(DynConn dc, int vertex, Edge *edge) {
+   Node *t = calloc(1, sizeof(Node));
+   assert(t != NULL);
+   dc->seed ^= dc->seed << 13;
+   dc->seed ^= dc->seed >> 17;
+   dc->seed ^= dc->seed << 5;
+   t->prio = dc->seed;
+   t->vertex = vertex;
+   t->edge = edge;
+   update(t);
+   return t;
+}
+
+static Node *join(Node *a, Node *b) {
+   if (a == NULL) return b;
+   if (b == NULL) return a;
+   if (a->prio > b->prio) {
+      a->right = join(a->right, b);
+      a->right->parent = a;
+      update(a);
+      return a;
+   }
+   b->left = join(a, b->left);
+   b->left->parent = b;
+   update(b);
+   return b;
+}
+
+// first k tour positions of t into *l, the rest into *r
+static void splitAt(Node *t, int k, Node **l, Node **r) {
+   if (t == NULL) {
+      *l = *r = NULL;
+      return;
+   }
+   if (countOf(t->left) < k) {
+      splitAt(t->right, k - countOf(t->left) - 1, &t->right, r);
+      if (t->right != NULL)
+         t->right->parent = t;
+      *l = t;
+   } else {
+      splitAt(t->left, k, l, &t->left);
+      if (t->left != NULL)
+         t->left->parent = t;
+      *r = t;
+   }
+   update(t);
+}
+
+static void split(Node *t, int k, Node **l, Node **r) {
+   splitAt(t, k, l, r);
+   if (*l != NULL) (*l)->parent = NULL;
+   if (*r != NULL) (*r)->parent = NULL;
+}
+
+static Node *rootOf(Node *t) {
+   while (t->parent != NULL)
+      t = t->parent;
+   return t;
+}
+
+// tour position of t
+static int indexOf(Node *t) {
+   int i = countOf(t->left);
+   for (; t->parent != NULL; t = t->parent)
+      if (t == t->parent->right)
+         i += countOf(t->parent->left) + 1;
+   return i;
+}
+
+static void setFlag(Node *t, int bit, bool on) {
+   t->flag = on ? t->flag | bit : t->flag & ~bit;
+   for (; t != NULL; t = t->parent)
+      update(t);
+}
+
+// leftmost node of tour t carrying a flag, or NULL
+static Node *findFlag(Node *t, int bit) {
+   if (!(aggOf(t) & bit))
+      return NULL;
+   for (;;) {
+      if (aggOf(t->left) & bit)
+         t = t->left;
+      else if (t->flag & bit)
+         return t;
+      else
+         t = t->right;
+   }
+}
+
+// rotate the tour so that it starts at t
+static Node *reroot(Node *t) {
+   Node *a, *b;
+   split(rootOf(t), indexOf(t), &a, &b);
+   Node *r = join(b, a);
+   r->parent = NULL;
+   return r;
+}
+
+/* ---------- forests ---------- */
+
+// node of v in F_i, created on demand
+static Node *vertexNode(DynConn dc, int v, int i) {
+   if (i >= dc->nAt[v]) {
+      dc->at[v] = realloc(dc->at[v], (i + 1) * sizeof(Node *));
+      assert(dc->at[v] != NULL);
+      for (int j = dc->nAt[v]; j <= i; j++)
+         dc->at[v][j] = NULL;
+      dc->nAt[v] = i + 1;
+   }
+   if (dc->at[v][i] == NULL)
+      dc->at[v][i] = newNode(dc, v, NULL);
+   return dc->at[v][i];
+}
+
+// node of v in F_i, or NULL if v is alone there
+static Node *findNode(DynConn dc, int v, int i) {
+   return i < dc->nAt[v] ? dc->at[v][i] : NULL;
+}
+
+static bool sameTree(DynConn dc, int v, int w, int i) {
+   Node *a = findNode(dc, v, i), *b = findNode(dc, w, i);
+   if (a == NULL || b == NULL)
+      return v == w;
+   return rootOf(a) == rootOf(b);
+}
+
+// add tree edge e to F_i: tour(v) + (v,w) + tour(w) + (w,v)
+static void link(DynConn dc, Edge *e, int i) {
+   if (2 * i + 1 >= e->capArcs) {
+      e->capArcs = 2 * (i + 1);
+      e->arcs = realloc(e->arcs, e->capArcs * sizeof(Node *));
+      assert(e->arcs != NULL);
+   }
+   Node *tv = reroot(vertexNode(dc, e->v, i));
+   Node *tw = reroot(vertexNode(dc, e->w, i));
+   Node *vw = newNode(dc, -1, e), *wv = newNode(dc, -1, e);
+   if (e->level == i) {
+      vw->flag = TREE_FLAG;
+      update(vw);
+   }
+   e->arcs[2 * i] = vw;
+   e->arcs[2 * i + 1] = wv;
+   Node *r = join(join(join(tv, vw), tw), wv);
+   r->parent = NULL;
+}
+
+// remove tree edge e from F_i: A (v,w) B (w,v) C  ->  A C  and  B
+static void cut(Edge *e, int i) {
+   Node *x = e->arcs[2 * i], *y = e->arcs[2 * i + 1];
+   int px = indexOf(x), py = indexOf(y);
+   if (px > py) {
+      Node *t = x; x = y; y = t;
+      int tp = px; px = py; py = tp;
+   }
+   Node *a, *rest, *mid, *c, *first, *b, *last;
+   split(rootOf(x), px, &a, &rest);
+   split(rest, py - px + 1, &mid, &c);
+   split(mid, 1, &first, &b);
+   split(b, countOf(b) - 1, &b, &last);
+   Node *r = join(a, c);
+   if (r != NULL)
+      r->parent = NULL;
+   free(x);
+   free(y);
+}
+
+/* ---------- non-tree edge lists ---------- */
+
+static void pushAdj(Node *t, Edge *e, int *pos) {
+   if (t->nAdj == t->capAdj) {
+      t->capAdj = t->capAdj > 0 ? 2 * t->capAdj : 4;
+      t->adj = realloc(t->adj, t->capAdj * sizeof(Edge *));
+      assert(t->adj != NULL);
+   }
+   *pos = t->nAdj;
+   t->adj[t->nAdj++] = e;
+   if (t->nAdj == 1)
+      setFlag(t, NONTREE_FLAG, true);
+}
+
+static void popAdj(Node *t, int pos) {
+   Edge *moved = t->adj[--t->nAdj];
+   t->adj[pos] = moved;
+   if (moved->v == t->vertex)
+      moved->posV = pos;
+   else
+      moved->posW = pos;
+   if (t->nAdj == 0)
+      setFlag(t, NONTREE_FLAG, false);
+}
+
+static void addNonTree(DynConn dc, Edge *e) {
+   pushAdj(vertexNode(dc, e->v, e->level), e, &e->posV);
+   pushAdj(vertexNode(dc, e->w, e->level), e, &e->posW);
+}
+
+static void removeNonTree(DynConn dc, Edge *e) {
+   popAdj(findNode(dc, e->v, e->level), e->posV);
+   popAdj(findNode(dc, e->w, e->level), e->posW);
+}
+
+/* ---------- edge table ---------- */
+
+static size_t slotOf(DynConn dc, int v, int w) {
+   uint64_t key = (uint64_t)(v < w ? v : w) << 32 | (uint32_t)(v < w ? w : v);
+   size_t i = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & dc->mask;
+   for (Edge *e; (e = dc->table[i]) != NULL; i = (i + 1) & dc->mask)
+      if ((e->v == v && e->w == w) || (e->v == w && e->w == v))
+         break;
+   return i;
+}
+
+static void tableInsert(DynConn dc, Edge *e) {
+   if (2 * (dc->nEdges + 1) > dc->mask + 1) {        // keep load <= 1/2
+      Edge **old = dc->table;
+      size_t oldCap = dc->mask + 1;
+      dc->mask = 2 * oldCap - 1;
+      dc->table = calloc(2 * oldCap, sizeof(Edge *));
+      assert(dc->table != NULL);
+      for (size_t i = 0; i < oldCap; i++)
+         if (old[i] != NULL)
+            dc->table[slotOf(dc, old[i]->v, old[i]->w)] = old[i];
+      free(old);
+   }
+   size_t i = slotOf(dc, e->v, e->w);
+   assert(dc->table[i] == NULL);
+   dc->table[i] = e;
+   dc->nEdges++;
+}
+
+static Edge *tableRemove(DynConn dc, int v, int w) {
+   size_t i = slotOf(dc, v, w);
+   Edge *e = dc->table[i];
+   assert(e != NULL);
+   dc->table[i] = NULL;
+   dc->nEdges--;
+   // shift later entries of the probe run back into the hole
+   for (size_t j = (i + 1) & dc->mask; dc->table[j] != NULL; j = (j + 1) & dc->mask) {
+      Edge *f = dc->table[j];
+      dc->table[j] = NULL;
+      dc->table[slotOf(dc, f->v, f->w)] = f;
+   }
+   return e;
+}
+
+/* ---------- operations ---------- */
+
+DynConn newDynConn(int n) {
+   assert(n >= 0);
+
+   DynConn dc = malloc(sizeof(DynConnRep));
+   assert(dc != NULL);
+   dc->nV = n;
+   dc->at = calloc(n > 0 ? n : 1, sizeof(Node **));
+   dc->nAt = calloc(n > 0 ? n : 1, sizeof(int));
+   dc->mask = 15;
+   dc->table = calloc(dc->mask + 1, sizeof(Edge *));
+   assert(dc->at != NULL && dc->nAt != NULL && dc->table != NULL);
+   dc->nEdges = 0;
+   dc->seed = 2463534242u;
+   return dc;
+}
+
+void dcInsert(DynConn dc, int v, int w) {
+   assert(dc != NULL && v >= 0 && v < dc->nV && w >= 0 && w < dc->nV);
+   if (v == w)                                   // loops never change connectivity
+      return;
+
+   Edge *e = calloc(1, sizeof(Edge));
+   assert(e != NULL);
+   e->v = v;
+   e->w = w;
+   tableInsert(dc, e);
+   if (sameTree(dc, v, w, 0)) {
+      addNonTree(dc, e);
+   } else {
+      e->tree = true;
+      link(dc, e, 0);
+   }
+}
+
+// after cutting a level-i tree edge between v and w, look for a replacement in F_i
+static bool replace(DynConn dc, int v, int w, int i) {
+   Node *nv = findNode(dc, v, i), *nw = findNode(dc, w, i);
+   int s = sizeOf(nv != NULL ? rootOf(nv) : NULL) <= sizeOf(nw != NULL ? rootOf(nw) : NULL) ? v : w;
+   Node *small = findNode(dc, s, i);
+   if (small == NULL)                            // a lone vertex has no edges at level i
+      return false;
+
+   // the smaller tree fits one level up: move its level-i tree edges there
+   for (Node *a; (a = findFlag(rootOf(small), TREE_FLAG)) != NULL; ) {
+      Edge *f = a->edge;
+      setFlag(a, TREE_FLAG, false);
+      f->level = i + 1;
+      link(dc, f, i + 1);
+   }
+
+   // try its level-i non-tree edges; those staying inside move up as well
+   for (Node *x; (x = findFlag(rootOf(small), NONTREE_FLAG)) != NULL; ) {
+      while (x->nAdj > 0) {
+         Edge *f = x->adj[x->nAdj - 1];
+         removeNonTree(dc, f);
+         int y = f->v == x->vertex ? f->w : f->v;
+         if (rootOf(findNode(dc, y, i)) == rootOf(small)) {
+            f->level = i + 1;
+            addNonTree(dc, f);
+         } else {
+            f->tree = true;
+            for (int j = 0; j <= i; j++)
+               link(dc, f, j);
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+void dcDelete(DynConn dc, int v, int w) {
+   assert(dc != NULL && v >= 0 && v < dc->nV && w >= 0 && w < dc->nV);
+   if (v == w)
+      return;
+
+   Edge *e = tableRemove(dc, v, w);
+   if (!e->tree) {
+      removeNonTree(dc, e);
+   } else {
+      for (int i = 0; i <= e->level; i++)
+         cut(e, i);
+      for (int i = e->level; i >= 0; i--)
+         if (replace(dc, v, w, i))
+            break;
+   }
+   free(e->arcs);
+   free(e);
+}
+
+bool dcConnected(DynConn dc, int v, int w) {
+   assert(dc != NULL && v >= 0 && v < dc->nV && w >= 0 && w < dc->nV);
+   return sameTree(dc, v, w, 0);
+}
+
+void freeDynConn(DynConn dc) {
+   assert(dc != NULL);
+
+   for (size_t i = 0; i <= dc->mask; i++) {
+      Edge *e = dc->table[i];
+      if (e != NULL) {
+         if (e->tree)
+            for (int j = 0; j <= e->level; j++) {
+               free(e->arcs[2 * j]);
+               free(e->arcs[2 * j + 1]);
+            }
+         free(e->arcs);
+         free(e);
+      }
+   }
+   for (int v = 0; v < dc->nV; v++) {
+      for (int i = 0; i < dc->nAt[v]; i++)
+         if (dc->at[v][i] != NULL) {
+            free(dc->at[v][i]->adj);
+            free(dc->at[v][i]);
+         }
+      free(dc->at[v]);
+   }
+   free(dc->at);
+   free(dc->nAt);
+   free(dc->table);
+   free(dc);
+}
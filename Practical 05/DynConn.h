@@ -0,0 +1,16 @@
+// Dynamic connectivity ADT
+// Answers "are v and w connected?" while undirected edges come and go
+#ifndef DYNCONN_H
+#define DYNCONN_H
+
+#include <stdbool.h>
+
+typedef struct DynConnRep *DynConn;
+
+DynConn newDynConn(int);             // vertices 0..n-1, no edges
+void  dcInsert(DynConn, int, int);   // add edge v-w (must not be present)
+void  dcDelete(DynConn, int, int);   // remove edge v-w (must be present)
+bool  dcConnected(DynConn, int, int);
+void  freeDynConn(DynConn);
+
+#endif
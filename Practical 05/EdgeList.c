@@ -0,0 +1,248 @@
+// Non-interactive edge-list input
+// Text is split into chunks at whitespace and the chunks are parsed in parallel
+#define _POSIX_C_SOURCE 200809L
+#include "EdgeList.h"
+#include "Parallel.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TEXT_CHUNK (1 << 20)     // bytes of text per parse step
+#define EDGE_CHUNK (1 << 16)     // edges per validation step
+
+#define IS_SPACE(c) ((c) == ' ' || (c) == '\n' || (c) == '\t' || (c) == '\r' || (c) == '\v' || (c) == '\f')
+#define IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+
+/* ---------- binary files ---------- */
+
+typedef struct {
+   const uint32_t *ends;   // 2 * nE endpoints
+   long            n;      // #endpoints
+   uint32_t        nV;
+   int             bad;    // set if any endpoint is out of range
+} Check;
+
+static void checkRange(int lo, int hi, int thread, void *arg) {
+   Check *c = arg;
+   long from = (long)lo * EDGE_CHUNK * 2, to = (long)hi * EDGE_CHUNK * 2;
+   uint32_t worst = 0;
+   for (long i = from; i < to && i < c->n; i++)
+      worst = c->ends[i] > worst ? c->ends[i] : worst;
+   if (worst >= c->nV)
+      __atomic_store_n(&c->bad, 1, __ATOMIC_RELAXED);   // other chunks may set it too
+}
+
+static bool loadBinary(const char *path, void *map, size_t len, int nThreads, EdgeList *out) {
+   EdgeFileHeader h;
+   memcpy(&h, map, sizeof h);
+   if (h.nV < 1 || h.nV > INT_MAX || h.nE > LONG_MAX / 8
+       || (len - sizeof h) / (2 * sizeof(uint32_t)) < h.nE) {
+      fprintf(stderr, "%s: bad edge file header.\n", path);
+      return false;
+   }
+
+   Check c = { (const uint32_t *)((const char *)map + sizeof h), 2 * (long)h.nE, h.nV, 0 };
+   parallelFor((h.nE + EDGE_CHUNK - 1) / EDGE_CHUNK, 1, nThreads, checkRange, &c);
+   if (c.bad) {
+      fprintf(stderr, "%s: edge endpoint out of range.\n", path);
+      return false;
+   }
+
+   // endpoints are below nV <= INT_MAX, so the pairs read as Edges
+   out->nV = h.nV;
+   out->nE = h.nE;
+   out->edges = (const Edge *)c.ends;
+   return true;
+}
+
+/* ---------- text ---------- */
+
+typedef struct {
+   long *tokens;           // integers in this chunk, in order
+   long  n, cap;
+   bool  stopped;          // hit a token that is not an integer
+} Piece;
+
+typedef struct {
+   const char *text;
+   size_t      len;
+   size_t     *cuts;       // chunk c covers text[cuts[c] .. cuts[c+1]-1]
+   Piece      *pieces;
+} Parse;
+
+static void parseRange(int lo, int hi, int thread, void *arg) {
+   Parse *p = arg;
+   for (int c = lo; c < hi; c++) {
+      Piece *pc = &p->pieces[c];
+      const char *s = p->text + p->cuts[c], *end = p->text + p->cuts[c + 1];
+      for (;;) {
+         while (s < end && IS_SPACE(*s))
+            s++;
+         if (s == end)
+            break;
+         bool neg = *s == '-';
+         if (*s == '-' || *s == '+')
+            s++;
+         if (s == end || !IS_DIGIT(*s)) {
+            pc->stopped = true;
+            break;
+         }
+         long x = 0;
+         for (; s < end && IS_DIGIT(*s); s++)
+            if (x <= INT_MAX)              // saturate; caught by range checks
+               x = 10 * x + (*s - '0');
+         if (pc->n == pc->cap) {
+            pc->cap = pc->cap > 0 ? 2 * pc->cap : 1024;
+            pc->tokens = realloc(pc->tokens, pc->cap * sizeof(long));
+            assert(pc->tokens != NULL);
+         }
+         pc->tokens[pc->n++] = neg ? -x : x;
+         // like scanf, stop after an integer that runs into a non-space
+         if (s < end && !IS_SPACE(*s)) {
+            pc->stopped = true;
+            break;
+         }
+      }
+   }
+}
+
+static bool loadText(const char *path, const char *text, size_t len, int nThreads, EdgeList *out) {
+   // cut at whitespace so no token spans two chunks
+   int nChunks = len / TEXT_CHUNK + 1;
+   Parse p = { text, len, malloc((nChunks + 1) * sizeof(size_t)), calloc(nChunks, sizeof(Piece)) };
+   assert(p.cuts != NULL && p.pieces != NULL);
+   p.cuts[0] = 0;
+   for (int c = 1; c < nChunks; c++) {
+      size_t at = (size_t)c * TEXT_CHUNK;
+      if (at < p.cuts[c - 1])
+         at = p.cuts[c - 1];
+      while (at < len && !IS_SPACE(text[at]))
+         at++;
+      p.cuts[c] = at;
+   }
+   p.cuts[nChunks] = len;
+   parallelFor(nChunks, 1, nThreads, parseRange, &p);
+
+   // concatenate the tokens before the first one that is not an integer
+   long nTokens = 0;
+   for (int c = 0; c < nChunks; c++) {
+      nTokens += p.pieces[c].n;
+      if (p.pieces[c].stopped)
+         break;
+   }
+
+   // the first token is the vertex count, the rest pair up into edges
+   long nE = nTokens > 0 ? (nTokens - 1) / 2 : 0;
+   Edge *edges = malloc((nE > 0 ? nE : 1) * sizeof(Edge));
+   assert(edges != NULL);
+   long nV = 0, k = -1;
+   bool ok = true;
+   for (int c = 0; ok && c < nChunks && k < 2 * nE; c++)
+      for (long i = 0; ok && i < p.pieces[c].n && k < 2 * nE; i++, k++) {
+         long x = p.pieces[c].tokens[i];
+         if (k < 0) {
+            nV = x;
+            ok = nV >= 1 && nV <= INT_MAX;
+         } else if (x < 0 || x >= nV) {
+            fprintf(stderr, "%s: edge endpoint %ld out of range.\n", path, x);
+            ok = false;
+         } else if (k % 2 == 0) {
+            edges[k / 2].v = x;
+         } else {
+            edges[k / 2].w = x;
+         }
+      }
+   if (nV < 1 || nV > INT_MAX) {
+      fprintf(stderr, "%s: invalid number of vertices.\n", path);
+      ok = false;
+   }
+   out->nV = nV;
+   out->nE = nE;
+   out->edges = out->owned = edges;
+
+   for (int c = 0; c < nChunks; c++)
+      free(p.pieces[c].tokens);
+   free(p.pieces);
+   free(p.cuts);
+   return ok;
+}
+
+// all of stdin in one buffer
+static char *slurp(FILE *in, size_t *len) {
+   size_t cap = 1 << 16, n = 0, got;
+   char *buf = malloc(cap);
+   assert(buf != NULL);
+   while ((got = fread(buf + n, 1, cap - n, in)) > 0) {
+      n += got;
+      if (n == cap) {
+         cap *= 2;
+         buf = realloc(buf, cap);
+         assert(buf != NULL);
+      }
+   }
+   *len = n;
+   return buf;
+}
+
+bool loadEdgeList(const char *path, int nThreads, EdgeList *out) {
+   assert(path != NULL && out != NULL);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+   memset(out, 0, sizeof *out);
+
+   if (strcmp(path, "-") == 0) {
+      size_t len;
+      char *text = slurp(stdin, &len);
+      bool ok = loadText("stdin", text, len, nThreads, out);
+      free(text);
+      if (!ok)
+         freeEdgeList(out);
+      return ok;
+   }
+
+   int fd = open(path, O_RDONLY);
+   struct stat st;
+   if (fd < 0 || fstat(fd, &st) != 0) {
+      perror(path);
+      if (fd >= 0)
+         close(fd);
+      return false;
+   }
+   size_t len = st.st_size;
+   void *map = len > 0 ? mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+   close(fd);
+   if (len > 0 && map == MAP_FAILED) {
+      perror(path);
+      return false;
+   }
+   out->map = map;
+   out->mapLen = len;
+
+   bool ok;
+   if (len >= sizeof(EdgeFileHeader) && memcmp(map, EDGE_FILE_MAGIC, 4) == 0) {
+      posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+      ok = loadBinary(path, map, len, nThreads, out);
+   } else {
+      ok = loadText(path, map, len, nThreads, out);
+      if (len > 0)
+         munmap(map, len);                    // text is parsed into out->owned
+      out->map = NULL;
+   }
+   if (!ok)
+      freeEdgeList(out);
+   return ok;
+}
+
+void freeEdgeList(EdgeList *el) {
+   assert(el != NULL);
+   if (el->map != NULL)
+      munmap(el->map, el->mapLen);
+   free(el->owned);
+   memset(el, 0, sizeof *el);
+}
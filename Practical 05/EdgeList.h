@@ -0,0 +1,36 @@
+// Non-interactive edge-list input
+//
+// Binary files start with an EdgeFileHeader followed by nE pairs of uint32
+// endpoints (v, w) in host byte order; they are memory-mapped, not copied.
+// Anything else is text in the same shape as the interactive input without
+// the prompts: the number of vertices, then "v w" pairs, ending at end of
+// file or at the first token that is not an integer.
+#ifndef EDGELIST_H
+#define EDGELIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Graph.h"
+
+#define EDGE_FILE_MAGIC "GEL1"
+
+typedef struct EdgeFileHeader {
+   char     magic[4];   // EDGE_FILE_MAGIC, no terminating '\0'
+   uint32_t nV;         // #vertices
+   uint64_t nE;         // #edge pairs that follow
+} EdgeFileHeader;
+
+typedef struct EdgeList {
+   int         nV;      // #vertices
+   long        nE;      // #edges
+   const Edge *edges;   // every endpoint in 0..nV-1
+   void       *map;     // mapped binary file, or NULL
+   size_t      mapLen;
+   Edge       *owned;   // parsed text edges, or NULL
+} EdgeList;
+
+// load path ("-" reads text from stdin); on failure reports on stderr, returns false
+bool loadEdgeList(const char *path, int nThreads, EdgeList *out);
+void freeEdgeList(EdgeList *);
+
+#endif
@@ -1,37 +1,326 @@
 // Graph ADT
-// Adjacency Matrix Representation ... COMP9024 25T1
+// Adaptive Representation: sorted neighbour arrays or bit-packed matrix ... COMP9024 25T1
+//
+// A graph starts with a sorted neighbour array per vertex.  When its density
+// 2E/V^2 rises past the graph's threshold it moves to a bit-packed adjacency
+// matrix, and it moves back once the density falls below a quarter of the
+// threshold.  A switch costs O(V^2/64 + E), and at least a constant fraction
+// of threshold * V^2 edge changes separate two switches, so the cost is
+// amortised over those changes.
 #include "Graph.h"
+#include "DynConn.h"
+#include "Parallel.h"
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 
+#define CACHE_LINE 64                          // bytes per cache line
+#define WORD_BITS 64                           // bits per matrix word
+#define LINE_WORDS (CACHE_LINE / sizeof(uint64_t))
+#define BULK_CHUNK 4096                        // edges per bulk-insert step
+#define DEFAULT_THRESHOLD (1.0 / 32)           // matrix and arrays take equal space
+#define HYSTERESIS 4                           // back to arrays below threshold / 4
+
+typedef struct AdjList {
+   Vertex *nbr;        // neighbours, ascending (length is the vertex's degree)
+   int     cap;        // allocated length
+} AdjList;
+
 typedef struct GraphRep {
-   int  **edges;   // adjacency matrix
-   int    nV;      // #vertices
-   int    nE;      // #edges
+   bool      dense;    // matrix (true) or neighbour arrays (false)
+   uint64_t *bits;     // dense: adjacency matrix, one bit per vertex pair, row by row
+   size_t    rowWords; // dense: #words per row, padded to whole cache lines
+   AdjList  *adj;      // sparse: neighbours of each vertex
+   int      *degree;   // #neighbours of each vertex
+   int       nV;       // #vertices
+   int       nE;       // #edges
+   double    threshold;// density at which to switch to the matrix
+   long      filling;  // edges newGraphSized expects; no switch before nE reaches it
+   DynConn   conn;     // connectivity index, NULL until first needed
 } GraphRep;
 
-Graph newGraph(int V) {
+// word and bit mask holding edge v-w
+#define ROW(g,v)   ((g)->bits + (size_t)(v) * (g)->rowWords)
+#define WORD(w)    ((w) / WORD_BITS)
+#define MASK(w)    ((uint64_t)1 << ((w) % WORD_BITS))
+
+// #edges at which a graph changes representation
+#define DENSE_AT(g)  ((g)->threshold * (g)->nV * (double)(g)->nV / 2)
+#define SPARSE_AT(g) (DENSE_AT(g) / HYSTERESIS)
+
+/* ---------- representations ---------- */
+
+// first index in a[0..n-1] with a[i] >= x
+static int search(const Vertex *a, int n, Vertex x) {
+   int lo = 0, hi = n;
+   while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (a[mid] < x)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+static bool hasEdge(Graph g, Vertex v, Vertex w) {
+   if (g->dense)
+      return (ROW(g,v)[WORD(w)] & MASK(w)) != 0;
+   if (g->degree[v] > g->degree[w]) {       // search the shorter list
+      Vertex t = v; v = w; w = t;
+   }
+   int i = search(g->adj[v].nbr, g->degree[v], w);
+   return i < g->degree[v] && g->adj[v].nbr[i] == w;
+}
+
+static void addNeighbour(Graph g, Vertex v, Vertex w) {
+   AdjList *a = &g->adj[v];
+   int n = g->degree[v];
+   if (n == a->cap) {
+      a->cap = a->cap > 0 ? 2 * a->cap : 4;
+      a->nbr = realloc(a->nbr, a->cap * sizeof(Vertex));
+      assert(a->nbr != NULL);
+   }
+   int i = search(a->nbr, n, w);
+   memmove(a->nbr + i + 1, a->nbr + i, (n - i) * sizeof(Vertex));
+   a->nbr[i] = w;
+}
+
+static void dropNeighbour(Graph g, Vertex v, Vertex w) {
+   AdjList *a = &g->adj[v];
+   int n = g->degree[v];
+   int i = search(a->nbr, n, w);
+   memmove(a->nbr + i, a->nbr + i + 1, (n - i - 1) * sizeof(Vertex));
+}
+
+static uint64_t *newMatrix(int V, size_t *rowWords) {
+   // round each row up to a whole number of cache lines
+   size_t words = (V + WORD_BITS - 1) / WORD_BITS;
+   *rowWords = (words + LINE_WORDS - 1) / LINE_WORDS * LINE_WORDS;
+
+   // one cache-line aligned block for the whole matrix, all bits 0
+   size_t bytes = (size_t)V * *rowWords * sizeof(uint64_t);
+   uint64_t *bits = aligned_alloc(CACHE_LINE, bytes > 0 ? bytes : CACHE_LINE);
+   assert(bits != NULL);
+   memset(bits, 0, bytes);
+   return bits;
+}
+
+static void toDense(Graph g) {
+   g->bits = newMatrix(g->nV, &g->rowWords);
+   for (Vertex v = 0; v < g->nV; v++) {
+      for (int i = 0; i < g->degree[v]; i++)
+         ROW(g,v)[WORD(g->adj[v].nbr[i])] |= MASK(g->adj[v].nbr[i]);
+      free(g->adj[v].nbr);
+   }
+   free(g->adj);
+   g->adj = NULL;
+   g->dense = true;
+}
+
+static void toSparse(Graph g) {
+   g->adj = malloc((g->nV > 0 ? g->nV : 1) * sizeof(AdjList));
+   assert(g->adj != NULL);
+   for (Vertex v = 0; v < g->nV; v++) {
+      AdjList *a = &g->adj[v];
+      a->cap = g->degree[v];
+      a->nbr = malloc((a->cap > 0 ? a->cap : 1) * sizeof(Vertex));
+      assert(a->nbr != NULL);
+      int n = 0;
+      for (size_t i = 0; i < g->rowWords; i++)
+         for (uint64_t m = ROW(g,v)[i]; m != 0; m &= m - 1)
+            a->nbr[n++] = i * WORD_BITS + __builtin_ctzll(m);
+   }
+   free(g->bits);
+   g->bits = NULL;
+   g->dense = false;
+}
+
+// switch representation if the density has left the current one's range;
+// a graph still filling up to its expected size keeps its representation
+static void rebalance(Graph g) {
+   if (g->nE < g->filling)
+      return;
+   g->filling = 0;
+   if (!g->dense && g->nE > DENSE_AT(g))
+      toDense(g);
+   else if (g->dense && g->nE < SPARSE_AT(g))
+      toSparse(g);
+}
+
+static Graph emptyGraph(int V, bool dense) {
    assert(V >= 0);
-   int i;
 
    Graph g = malloc(sizeof(GraphRep));
    assert(g != NULL);
    g->nV = V;
    g->nE = 0;
+   g->threshold = DEFAULT_THRESHOLD;
+   g->filling = 0;
+   g->dense = dense;
+   g->bits = NULL;
+   g->adj = NULL;
+   if (dense) {
+      g->bits = newMatrix(V, &g->rowWords);
+   } else {
+      g->adj = calloc(V > 0 ? V : 1, sizeof(AdjList));
+      assert(g->adj != NULL);
+   }
 
-   // allocate memory for each row
-   g->edges = malloc(V * sizeof(int *));
-   assert(g->edges != NULL);
-   // allocate memory for each column and initialise with 0
-   for (i = 0; i < V; i++) {
-      g->edges[i] = calloc(V, sizeof(int));
-      assert(g->edges[i] != NULL);
+   g->degree = calloc(V > 0 ? V : 1, sizeof(int));
+   assert(g->degree != NULL);
+   g->conn = NULL;
+
+   return g;
+}
+
+Graph newGraph(int V) {
+   return emptyGraph(V, false);
+}
+
+// start in the representation suited to about nE edges, and keep it until
+// that many are in, so the first inserts do not switch back and forth
+Graph newGraphSized(int V, long nE) {
+   Graph g = emptyGraph(V, false);
+   if (nE > DENSE_AT(g)) {
+      free(g->adj);
+      g->adj = NULL;
+      g->bits = newMatrix(V, &g->rowWords);
+      g->dense = true;
+      g->filling = nE;
    }
+   return g;
+}
+
+/* ---------- bulk construction ---------- */
+
+typedef struct {
+   Graph       g;
+   const Edge *edges;
+   long        nE;
+   long       *loops;   // per thread: #loops among the rows counted
+   int        *fill;    // sparse: next free slot of each row
+} Bulk;
+
+static void setEdges(int lo, int hi, int thread, void *arg) {
+   Bulk *b = arg;
+   Graph g = b->g;
+   long to = (long)hi * BULK_CHUNK < b->nE ? (long)hi * BULK_CHUNK : b->nE;
+   for (long i = (long)lo * BULK_CHUNK; i < to; i++) {
+      Vertex v = b->edges[i].v, w = b->edges[i].w;
+      __atomic_fetch_or(&ROW(g,v)[WORD(w)], MASK(w), __ATOMIC_RELAXED);
+      __atomic_fetch_or(&ROW(g,w)[WORD(v)], MASK(v), __ATOMIC_RELAXED);
+   }
+}
+
+static void countRows(int lo, int hi, int thread, void *arg) {
+   Bulk *b = arg;
+   Graph g = b->g;
+   long loops = 0;
+   for (Vertex v = lo; v < hi; v++) {
+      int d = 0;
+      for (size_t i = 0; i < g->rowWords; i++)
+         d += __builtin_popcountll(ROW(g,v)[i]);
+      g->degree[v] = d;
+      loops += (ROW(g,v)[WORD(v)] & MASK(v)) != 0;
+   }
+   b->loops[thread * LINE_WORDS] += loops;
+}
 
+// sparse: count each row's entries (duplicates included) in fill
+static void countEnds(int lo, int hi, int thread, void *arg) {
+   Bulk *b = arg;
+   long to = (long)hi * BULK_CHUNK < b->nE ? (long)hi * BULK_CHUNK : b->nE;
+   for (long i = (long)lo * BULK_CHUNK; i < to; i++) {
+      __atomic_fetch_add(&b->fill[b->edges[i].v], 1, __ATOMIC_RELAXED);
+      if (b->edges[i].v != b->edges[i].w)
+         __atomic_fetch_add(&b->fill[b->edges[i].w], 1, __ATOMIC_RELAXED);
+   }
+}
+
+static void placeEnds(int lo, int hi, int thread, void *arg) {
+   Bulk *b = arg;
+   Graph g = b->g;
+   long to = (long)hi * BULK_CHUNK < b->nE ? (long)hi * BULK_CHUNK : b->nE;
+   for (long i = (long)lo * BULK_CHUNK; i < to; i++) {
+      Vertex v = b->edges[i].v, w = b->edges[i].w;
+      g->adj[v].nbr[__atomic_fetch_add(&b->fill[v], 1, __ATOMIC_RELAXED)] = w;
+      if (v != w)
+         g->adj[w].nbr[__atomic_fetch_add(&b->fill[w], 1, __ATOMIC_RELAXED)] = v;
+   }
+}
+
+static int cmpVertex(const void *a, const void *b) {
+   Vertex x = *(const Vertex *)a, y = *(const Vertex *)b;
+   return (x > y) - (x < y);
+}
+
+// sparse: sort each row and drop repeated neighbours
+static void sortRows(int lo, int hi, int thread, void *arg) {
+   Bulk *b = arg;
+   Graph g = b->g;
+   long loops = 0;
+   for (Vertex v = lo; v < hi; v++) {
+      Vertex *a = g->adj[v].nbr;
+      int n = b->fill[v], d = 0;
+      qsort(a, n, sizeof(Vertex), cmpVertex);
+      for (int i = 0; i < n; i++)
+         if (d == 0 || a[i] != a[d - 1])
+            a[d++] = a[i];
+      g->degree[v] = d;
+      loops += search(a, d, v) < d && a[search(a, d, v)] == v;
+   }
+   b->loops[thread * LINE_WORDS] += loops;
+}
+
+// build a graph from many edges at once; duplicates are ignored as with
+// insertEdge, but endpoints are trusted to be valid
+Graph newGraphFromEdges(int V, const Edge *edges, long nE, int nThreads) {
+   assert(nE >= 0 && (edges != NULL || nE == 0));
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+
+   Graph g = newGraphSized(V, nE);
+   Bulk b = { g, edges, nE, calloc(nThreads * LINE_WORDS, sizeof(long)), NULL };
+   assert(b.loops != NULL);
+   int nChunks = (nE + BULK_CHUNK - 1) / BULK_CHUNK;
+
+   if (g->dense) {
+      // set bits in parallel, then derive degrees and the edge count per row
+      parallelFor(nChunks, 1, nThreads, setEdges, &b);
+      parallelFor(V, 256, nThreads, countRows, &b);
+   } else {
+      // size each row, scatter the ends into place, then sort and dedupe rows
+      b.fill = calloc(V > 0 ? V : 1, sizeof(int));
+      assert(b.fill != NULL);
+      parallelFor(nChunks, 1, nThreads, countEnds, &b);
+      for (Vertex v = 0; v < V; v++) {
+         g->adj[v].cap = b.fill[v];
+         g->adj[v].nbr = malloc((b.fill[v] > 0 ? b.fill[v] : 1) * sizeof(Vertex));
+         assert(g->adj[v].nbr != NULL);
+         b.fill[v] = 0;
+      }
+      parallelFor(nChunks, 1, nThreads, placeEnds, &b);
+      parallelFor(V, 256, nThreads, sortRows, &b);
+      free(b.fill);
+   }
+
+   long sum = 0, loops = 0;
+   for (Vertex v = 0; v < V; v++)
+      sum += g->degree[v];
+   for (int t = 0; t < nThreads; t++)
+      loops += b.loops[t * LINE_WORDS];
+   g->nE = (sum + loops) / 2;                    // a loop is counted once in sum
+   free(b.loops);
+   g->filling = 0;
+   rebalance(g);                                 // duplicates may have thinned it out
    return g;
 }
 
+/* ---------- operations ---------- */
+
 int numOfVertices(Graph g) {
    return g->nV;
 }
@@ -44,27 +333,131 @@ bool validV(Graph g, Vertex v) {
 void insertEdge(Graph g, Edge e) {
    assert(g != NULL && validV(g,e.v) && validV(g,e.w));
 
-   if (!g->edges[e.v][e.w]) {  // edge e not in graph
-      g->edges[e.v][e.w] = 1;
-      g->edges[e.w][e.v] = 1;
+   if (!hasEdge(g, e.v, e.w)) {                 // edge e not in graph
+      if (g->dense) {
+         ROW(g,e.v)[WORD(e.w)] |= MASK(e.w);
+         ROW(g,e.w)[WORD(e.v)] |= MASK(e.v);
+      } else {
+         addNeighbour(g, e.v, e.w);
+         if (e.v != e.w)
+            addNeighbour(g, e.w, e.v);
+      }
+      g->degree[e.v]++;
+      if (e.v != e.w)                           // a loop is one neighbour
+         g->degree[e.w]++;
       g->nE++;
+      if (g->conn != NULL)
+         dcInsert(g->conn, e.v, e.w);
+      rebalance(g);
    }
 }
 
 void removeEdge(Graph g, Edge e) {
    assert(g != NULL && validV(g,e.v) && validV(g,e.w));
 
-   if (g->edges[e.v][e.w]) {   // edge e in graph
-      g->edges[e.v][e.w] = 0;
-      g->edges[e.w][e.v] = 0;
+   if (hasEdge(g, e.v, e.w)) {                  // edge e in graph
+      if (g->dense) {
+         ROW(g,e.v)[WORD(e.w)] &= ~MASK(e.w);
+         ROW(g,e.w)[WORD(e.v)] &= ~MASK(e.v);
+      } else {
+         dropNeighbour(g, e.v, e.w);
+         if (e.v != e.w)
+            dropNeighbour(g, e.w, e.v);
+      }
+      g->degree[e.v]--;
+      if (e.v != e.w)
+         g->degree[e.w]--;
       g->nE--;
+      if (g->conn != NULL)
+         dcDelete(g->conn, e.v, e.w);
+      rebalance(g);
    }
 }
 
 bool adjacent(Graph g, Vertex v, Vertex w) {
    assert(g != NULL && validV(g,v) && validV(g,w));
 
-   return (g->edges[v][w] != 0);
+   return hasEdge(g, v, w);
+}
+
+int degree(Graph g, Vertex v) {
+   assert(g != NULL && validV(g,v));
+
+   return g->degree[v];
+}
+
+Vertex firstNeighbour(Graph g, Vertex v) {
+   return nextNeighbour(g, v, -1);
+}
+
+// dense: scan row v a word at a time for the first set bit after w
+// sparse: binary search v's neighbours for the first one after w
+Vertex nextNeighbour(Graph g, Vertex v, Vertex w) {
+   assert(g != NULL && validV(g,v) && w >= -1 && w < g->nV);
+
+   if (!g->dense) {
+      int i = search(g->adj[v].nbr, g->degree[v], w + 1);
+      return i < g->degree[v] ? g->adj[v].nbr[i] : -1;
+   }
+
+   const uint64_t *row = ROW(g,v);
+   int from = w + 1;
+   size_t i = WORD(from);
+   size_t words = WORD(g->nV + WORD_BITS - 1);
+   if (i >= words)
+      return -1;
+   uint64_t word = row[i] & (~(uint64_t)0 << (from % WORD_BITS));
+   while (word == 0) {
+      if (++i == words)
+         return -1;
+      word = row[i];
+   }
+   return (Vertex)(i * WORD_BITS + __builtin_ctzll(word));
+}
+
+void setDensityThreshold(Graph g, double density) {
+   assert(g != NULL && density > 0);
+
+   g->threshold = density;
+   g->filling = 0;
+   rebalance(g);
+}
+
+GraphStats graphStats(Graph g) {
+   assert(g != NULL);
+
+   GraphStats s;
+   s.dense = g->dense;
+   s.nV = g->nV;
+   s.nE = g->nE;
+   s.bytes = sizeof(GraphRep) + (size_t)g->nV * sizeof(int);
+   if (g->dense) {
+      s.bytes += (size_t)g->nV * g->rowWords * sizeof(uint64_t);
+   } else {
+      s.bytes += (size_t)g->nV * sizeof(AdjList);
+      for (Vertex v = 0; v < g->nV; v++)
+         s.bytes += (size_t)g->adj[v].cap * sizeof(Vertex);
+   }
+   return s;
+}
+
+// from now on keep a connectivity index up to date with every edge change
+void trackConnectivity(Graph g) {
+   assert(g != NULL);
+
+   if (g->conn != NULL)
+      return;
+   g->conn = newDynConn(g->nV);
+   for (Vertex v = 0; v < g->nV; v++)
+      for (Vertex w = nextNeighbour(g, v, v); w != -1; w = nextNeighbour(g, v, w))
+         dcInsert(g->conn, v, w);
+}
+
+bool connected(Graph g, Vertex v, Vertex w) {
+   assert(g != NULL && validV(g,v) && validV(g,w));
+
+   trackConnectivity(g);
+   return dcConnected(g->conn, v, w);
 }
 
 void showGraph(Graph g) {
@@ -74,17 +467,22 @@ void showGraph(Graph g) {
     printf("Number of vertices: %d\n", g->nV);
     printf("Number of edges: %d\n", g->nE);
     for (i = 0; i < g->nV; i++)
-       for (j = i+1; j < g->nV; j++)
-	  if (g->edges[i][j])
+       for (j = nextNeighbour(g, i, i); j != -1; j = nextNeighbour(g, i, j))
 	      printf("Edge %d - %d\n", i, j);
 }
 
 void freeGraph(Graph g) {
    assert(g != NULL);
 
-   int i;
-   for (i = 0; i < g->nV; i++)
-      free(g->edges[i]);
-   free(g->edges);
+   if (g->conn != NULL)
+      freeDynConn(g->conn);
+   if (g->dense) {
+      free(g->bits);
+   } else {
+      for (Vertex v = 0; v < g->nV; v++)
+         free(g->adj[v].nbr);
+      free(g->adj);
+   }
+   free(g->degree);
    free(g);
-}
\ No newline at end of file
+}
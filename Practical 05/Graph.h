@@ -1,5 +1,9 @@
 // Graph ADT interface ... COMP9024 25T1
+#ifndef GRAPH_H
+#define GRAPH_H
+
 #include <stdbool.h>
+#include <stddef.h>
 
 typedef struct GraphRep *Graph;
 
@@ -12,10 +16,29 @@ typedef struct Edge {
    Vertex w;
 } Edge;
 
+// current representation of a graph and the heap memory it holds
+typedef struct GraphStats {
+   bool   dense;   // adjacency matrix (true) or sorted neighbour arrays (false)
+   int    nV;
+   int    nE;
+   size_t bytes;
+} GraphStats;
+
 Graph newGraph(int);
+Graph newGraphSized(int, long);                         // expecting about this many edges
+Graph newGraphFromEdges(int, const Edge *, long, int);  // bulk build, valid edges only
 int   numOfVertices(Graph);
 void  insertEdge(Graph, Edge);
 void  removeEdge(Graph, Edge);
 bool  adjacent(Graph, Vertex, Vertex);
+int   degree(Graph, Vertex);                 // #neighbours of a vertex
+Vertex firstNeighbour(Graph, Vertex);        // lowest neighbour, or -1 if none
+Vertex nextNeighbour(Graph, Vertex, Vertex); // next neighbour after w, or -1
+void  trackConnectivity(Graph);              // maintain connectivity under updates
+bool  connected(Graph, Vertex, Vertex);      // path between v and w? (tracks on first use)
+void  setDensityThreshold(Graph, double);    // use a matrix once 2E/V^2 exceeds this
+GraphStats graphStats(Graph);
 void  showGraph(Graph);
-void  freeGraph(Graph);
\ No newline at end of file
+void  freeGraph(Graph);
+
+#endif
@@ -0,0 +1,115 @@
+// Parallel loop helper on POSIX threads
+// Workers are started on first use and then parked between loops, so a loop
+// costs a wake-up rather than a thread creation
+#define _POSIX_C_SOURCE 200809L
+#include "Parallel.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+   atomic_int next;     // first index not yet claimed
+   int        n;        // loop runs over 0..n-1
+   int        chunk;    // #indices claimed at a time
+   RangeFn    body;
+   void      *arg;
+} Loop;
+
+typedef struct {
+   pthread_mutex_t busy;        // one loop at a time
+   pthread_mutex_t lock;        // guards the fields below
+   pthread_cond_t  start;       // a new loop is posted
+   pthread_cond_t  done;        // the last helper has finished
+   int             nWorkers;    // #parked threads (the caller is worker 0)
+   unsigned long   generation;  // bumped for every loop
+   int             active;      // workers 0..active-1 take part
+   int             running;     // #helpers still working on this loop
+   Loop           *loop;
+} Pool;
+
+static Pool pool = {
+   .busy = PTHREAD_MUTEX_INITIALIZER,
+   .lock = PTHREAD_MUTEX_INITIALIZER,
+   .start = PTHREAD_COND_INITIALIZER,
+   .done = PTHREAD_COND_INITIALIZER,
+};
+
+int defaultThreads(void) {
+   long n = sysconf(_SC_NPROCESSORS_ONLN);
+   return n > 0 ? (int)n : 1;
+}
+
+// claim chunks until the loop is exhausted
+static void runLoop(Loop *loop, int thread) {
+   int lo;
+   while ((lo = atomic_fetch_add(&loop->next, loop->chunk)) < loop->n) {
+      int hi = lo + loop->chunk < loop->n ? lo + loop->chunk : loop->n;
+      loop->body(lo, hi, thread, loop->arg);
+   }
+}
+
+static void *worker(void *p) {
+   int thread = (int)(intptr_t)p;
+   unsigned long seen = 0;        // generation 0 never runs, so a new
+                                  // worker joins the loop it was started for
+   pthread_mutex_lock(&pool.lock);
+   for (;;) {
+      while (pool.generation == seen)
+         pthread_cond_wait(&pool.start, &pool.lock);
+      seen = pool.generation;
+      if (thread >= pool.active)
+         continue;
+      Loop *loop = pool.loop;
+      pthread_mutex_unlock(&pool.lock);
+
+      runLoop(loop, thread);
+
+      pthread_mutex_lock(&pool.lock);
+      if (--pool.running == 0)
+         pthread_cond_signal(&pool.done);
+   }
+   return NULL;
+}
+
+void parallelFor(int n, int chunk, int nThreads, RangeFn body, void *arg) {
+   assert(n >= 0 && chunk > 0 && nThreads > 0 && body != NULL);
+
+   Loop loop = { .n = n, .chunk = chunk, .body = body, .arg = arg };
+   atomic_init(&loop.next, 0);
+
+   int spare = (n + chunk - 1) / chunk;          // no point in idle threads
+   if (nThreads > spare)
+      nThreads = spare > 0 ? spare : 1;
+   if (nThreads == 1) {
+      runLoop(&loop, 0);
+      return;
+   }
+
+   pthread_mutex_lock(&pool.busy);
+   pthread_mutex_lock(&pool.lock);
+   // if a thread cannot start, the others take its share
+   while (pool.nWorkers + 1 < nThreads) {
+      pthread_t tid;
+      if (pthread_create(&tid, NULL, worker, (void *)(intptr_t)(pool.nWorkers + 1)) != 0)
+         break;
+      pthread_detach(tid);
+      pool.nWorkers++;
+   }
+   pool.active = nThreads < pool.nWorkers + 1 ? nThreads : pool.nWorkers + 1;
+   pool.running = pool.active - 1;
+   pool.loop = &loop;
+   pool.generation++;
+   pthread_cond_broadcast(&pool.start);
+   pthread_mutex_unlock(&pool.lock);
+
+   runLoop(&loop, 0);
+
+   pthread_mutex_lock(&pool.lock);
+   while (pool.running > 0)
+      pthread_cond_wait(&pool.done, &pool.lock);
+   pthread_mutex_unlock(&pool.lock);
+   pthread_mutex_unlock(&pool.busy);
+}
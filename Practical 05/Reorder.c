@@ -0,0 +1,208 @@
+// Vertex reordering for memory locality
+#include "Reorder.h"
+#include "Parallel.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PERIPHERAL_TRIES 8   // George-Liu refinement rounds per component
+
+static long degreeOf(CSR *g, Vertex v) {
+   return g->offsets[v + 1] - g->offsets[v];
+}
+
+static int cmpKey(const void *a, const void *b) {
+   uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+   return (x > y) - (x < y);
+}
+
+static int cmpVertex(const void *a, const void *b) {
+   Vertex x = *(const Vertex *)a, y = *(const Vertex *)b;
+   return (x > y) - (x < y);
+}
+
+// vertices by degree (ascending or descending), ties by id
+static Vertex *byDegree(CSR *g, bool descending) {
+   long maxDeg = 0;
+   for (Vertex v = 0; v < g->nV; v++)
+      if (degreeOf(g, v) > maxDeg)
+         maxDeg = degreeOf(g, v);
+   long *start = calloc(maxDeg + 2, sizeof(long));
+   Vertex *order = malloc((g->nV > 0 ? g->nV : 1) * sizeof(Vertex));
+   assert(start != NULL && order != NULL);
+   for (Vertex v = 0; v < g->nV; v++)
+      start[(descending ? maxDeg - degreeOf(g, v) : degreeOf(g, v)) + 1]++;
+   for (long d = 0; d <= maxDeg; d++)
+      start[d + 1] += start[d];
+   for (Vertex v = 0; v < g->nV; v++)
+      order[start[descending ? maxDeg - degreeOf(g, v) : degreeOf(g, v)]++] = v;
+   free(start);
+   return order;
+}
+
+// BFS from src appending to order[*n..]; neighbours by ascending degree if
+// byDeg, else by id.  Reached vertices get mark[v] = stamp.  Returns the
+// depth of the search and sets *last to where its deepest level starts.
+static int visit(CSR *g, Vertex src, bool byDeg, Vertex *order, int *n,
+                 int *mark, int stamp, uint64_t *keys, int *last) {
+   int head = *n, depth = 0, levelEnd;
+   order[(*n)++] = src;
+   mark[src] = stamp;
+   *last = head;
+   levelEnd = *n;
+   while (head < *n) {
+      if (head == levelEnd) {
+         depth++;
+         *last = head;
+         levelEnd = *n;
+      }
+      Vertex v = order[head++];
+      int k = 0;
+      for (long i = g->offsets[v]; i < g->offsets[v + 1]; i++) {
+         Vertex w = g->targets[i];
+         if (mark[w] != stamp) {
+            mark[w] = stamp;
+            keys[k++] = (byDeg ? (uint64_t)degreeOf(g, w) << 32 : 0) | (uint32_t)w;
+         }
+      }
+      if (byDeg)
+         qsort(keys, k, sizeof(uint64_t), cmpKey);
+      for (int i = 0; i < k; i++)
+         order[(*n)++] = (Vertex)(uint32_t)keys[i];
+   }
+   return depth;
+}
+
+// reverse Cuthill-McKee, each component started from a pseudo-peripheral vertex
+static Vertex *rcm(CSR *g) {
+   int nV = g->nV;
+   Vertex *order = malloc((nV > 0 ? nV : 1) * sizeof(Vertex));
+   Vertex *trial = malloc((nV > 0 ? nV : 1) * sizeof(Vertex));
+   int *mark = calloc(nV > 0 ? nV : 1, sizeof(int));
+   uint64_t *keys = malloc((nV > 0 ? nV : 1) * sizeof(uint64_t));
+   assert(order != NULL && trial != NULL && mark != NULL && keys != NULL);
+
+   // trial searches stamp 1, 2, ...; -1 marks vertices already placed
+   Vertex *starts = byDegree(g, false);
+   int n = 0, stamp = 0, last;
+   for (int s = 0; s < nV; s++) {
+      Vertex r = starts[s];
+      if (mark[r] == -1)
+         continue;
+
+      // George-Liu: restart from a lowest-degree vertex of the deepest level
+      // while that makes the search deeper
+      int m = 0;
+      int ecc = visit(g, r, false, trial, &m, mark, ++stamp, keys, &last);
+      for (int t = 0; t < PERIPHERAL_TRIES; t++) {
+         Vertex best = trial[last];
+         for (int i = last; i < m; i++)
+            if (degreeOf(g, trial[i]) < degreeOf(g, best))
+               best = trial[i];
+         m = 0;
+         int e = visit(g, best, false, trial, &m, mark, ++stamp, keys, &last);
+         if (e <= ecc)
+            break;
+         r = best;
+         ecc = e;
+      }
+
+      int first = n;
+      visit(g, r, true, order, &n, mark, -1, keys, &last);
+      for (int i = first, j = n - 1; i < j; i++, j--) {
+         Vertex t = order[i]; order[i] = order[j]; order[j] = t;
+      }
+   }
+
+   free(starts);
+   free(trial);
+   free(mark);
+   free(keys);
+   return order;
+}
+
+// components in order of their lowest vertex, each breadth-first by id
+static Vertex *bfsOrder(CSR *g) {
+   int nV = g->nV, n = 0, last;
+   Vertex *order = malloc((nV > 0 ? nV : 1) * sizeof(Vertex));
+   int *mark = calloc(nV > 0 ? nV : 1, sizeof(int));
+   uint64_t *keys = malloc((nV > 0 ? nV : 1) * sizeof(uint64_t));
+   assert(order != NULL && mark != NULL && keys != NULL);
+   for (Vertex v = 0; v < nV; v++)
+      if (mark[v] == 0)
+         visit(g, v, false, order, &n, mark, 1, keys, &last);
+   free(mark);
+   free(keys);
+   return order;
+}
+
+Vertex *vertexOrdering(CSR *g, Ordering how) {
+   assert(g != NULL);
+   switch (how) {
+   case ORDER_RCM:    return rcm(g);
+   case ORDER_DEGREE: return byDegree(g, true);
+   case ORDER_BFS:    return bfsOrder(g);
+   }
+   assert(false);
+   return NULL;
+}
+
+Vertex *invertOrdering(const Vertex *order, int nV) {
+   Vertex *inv = malloc((nV > 0 ? nV : 1) * sizeof(Vertex));
+   assert(inv != NULL);
+   for (int i = 0; i < nV; i++)
+      inv[order[i]] = i;
+   return inv;
+}
+
+typedef struct {
+   CSR          *from, *to;
+   const Vertex *oldOf, *newOf;
+} Permute;
+
+static void permuteRows(int lo, int hi, int thread, void *arg) {
+   Permute *p = arg;
+   for (Vertex v = lo; v < hi; v++) {
+      Vertex old = p->oldOf[v];
+      Vertex *row = p->to->targets + p->to->offsets[v];
+      long d = degreeOf(p->from, old);
+      for (long i = 0; i < d; i++)
+         row[i] = p->newOf[p->from->targets[p->from->offsets[old] + i]];
+      qsort(row, d, sizeof(Vertex), cmpVertex);
+   }
+}
+
+CSR *permuteCSR(CSR *g, const Vertex *oldOf, const Vertex *newOf, int nThreads) {
+   assert(g != NULL && oldOf != NULL && newOf != NULL);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+
+   CSR *c = malloc(sizeof(CSR));
+   assert(c != NULL);
+   c->nV = g->nV;
+   c->nE = g->nE;
+   c->offsets = malloc((g->nV + 1) * sizeof(long));
+   c->targets = malloc((g->nE > 0 ? g->nE : 1) * sizeof(Vertex));
+   assert(c->offsets != NULL && c->targets != NULL);
+   c->offsets[0] = 0;
+   for (Vertex v = 0; v < g->nV; v++)
+      c->offsets[v + 1] = c->offsets[v] + degreeOf(g, oldOf[v]);
+
+   Permute p = { g, c, oldOf, newOf };
+   parallelFor(g->nV, 256, nThreads, permuteRows, &p);
+   return c;
+}
+
+long bandwidth(CSR *g) {
+   assert(g != NULL);
+   long bw = 0;
+   for (Vertex v = 0; v < g->nV; v++)
+      if (g->offsets[v + 1] > g->offsets[v]) {
+         // rows are ascending, so the ends are the farthest neighbours
+         long lo = v - g->targets[g->offsets[v]], hi = g->targets[g->offsets[v + 1] - 1] - v;
+         bw = lo > bw ? lo : bw;
+         bw = hi > bw ? hi : bw;
+      }
+   return bw;
+}
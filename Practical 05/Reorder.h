@@ -0,0 +1,19 @@
+// Vertex reordering for memory locality
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "CSR.h"
+
+typedef enum {
+   ORDER_RCM,      // reverse Cuthill-McKee: small bandwidth
+   ORDER_DEGREE,   // highest degree first: hubs share cache lines
+   ORDER_BFS       // breadth-first from vertex 0, component by component
+} Ordering;
+
+Vertex *vertexOrdering(CSR *, Ordering);           // oldOf[new] = old id; caller frees
+Vertex *invertOrdering(const Vertex *, int nV);    // newOf[old] = new id; caller frees
+CSR    *permuteCSR(CSR *, const Vertex *oldOf,     // copy with v renamed newOf[v]
+                   const Vertex *newOf, int nThreads);
+long    bandwidth(CSR *);                          // max |v - w| over all edges
+
+#endif
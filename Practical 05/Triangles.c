@@ -0,0 +1,332 @@
+// Triangle engine: counting, listing and clustering over a CSR view
+//
+// Counting orients each edge from lower to higher (degree, id) rank, so every
+// triangle is found once from its lowest-ranked corner and no out-list is
+// longer than sqrt(2m).  Out-lists are intersected either as sorted arrays
+// (see intersectRows) or, for dense graphs
+// that fit the budget, as bitset rows combined with AND + popcount.
+#define _POSIX_C_SOURCE 200809L
+#include "Triangles.h"
+#include "Parallel.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define CHUNK         64          // vertices claimed per parallelFor step
+#define BITSET_BYTES  (1L << 28)  // largest bitset matrix worth building
+#define LIST_ROUND    16          // chunks buffered per thread when listing
+
+/* ---------- bitset rows ---------- */
+
+// #bits set in a & b over words from..to-1 (from, to multiples of 4)
+static long andCount(const uint64_t *a, const uint64_t *b, size_t from, size_t to) {
+   long c = 0;
+   size_t w = from;
+#ifdef __AVX2__
+   // nibble-table popcount, summed per 64-bit lane with SAD
+   const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+   const __m256i low = _mm256_set1_epi8(0x0f);
+   __m256i acc = _mm256_setzero_si256();
+   for (; w < to; w += 4) {
+      __m256i x = _mm256_and_si256(_mm256_load_si256((const __m256i *)(a + w)),
+                                   _mm256_load_si256((const __m256i *)(b + w)));
+      __m256i n = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(x, low)),
+                                  _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), low)));
+      acc = _mm256_add_epi64(acc, _mm256_sad_epu8(n, _mm256_setzero_si256()));
+   }
+   c = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1)
+     + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+#endif
+   for (; w < to; w++)
+      c += __builtin_popcountll(a[w] & b[w]);
+   return c;
+}
+
+/* ---------- degree-ordered orientation ---------- */
+
+typedef struct {
+   int      nV;
+   Vertex  *order;     // order[r] = vertex of rank r
+   long    *offsets;   // out-list of rank r: targets[offsets[r] .. offsets[r+1]-1]
+   Vertex  *targets;   // higher ranks, ascending
+   int      maxOut;
+   uint64_t *bits;     // optional bitset rows of the out-lists (NULL if unused)
+   size_t   rowWords;
+} Oriented;
+
+static Oriented *orient(CSR *g) {
+   int nV = g->nV;
+   Oriented *o = malloc(sizeof(Oriented));
+   int *deg = malloc(nV * sizeof(int));
+   int *rank = malloc(nV * sizeof(int));
+   assert(o != NULL && deg != NULL && rank != NULL);
+
+   // rank vertices by (degree, id) with a stable counting sort
+   int maxDeg = 0;
+   for (Vertex v = 0; v < nV; v++) {
+      deg[v] = 0;
+      for (long i = g->offsets[v]; i < g->offsets[v + 1]; i++)
+         deg[v] += g->targets[i] != v;
+      if (deg[v] > maxDeg)
+         maxDeg = deg[v];
+   }
+   long *start = calloc(maxDeg + 2, sizeof(long));
+   o->order = malloc(nV * sizeof(Vertex));
+   assert(start != NULL && o->order != NULL);
+   for (Vertex v = 0; v < nV; v++)
+      start[deg[v] + 1]++;
+   for (int d = 0; d <= maxDeg; d++)
+      start[d + 1] += start[d];
+   for (Vertex v = 0; v < nV; v++) {
+      rank[v] = start[deg[v]]++;
+      o->order[rank[v]] = v;
+   }
+   free(start);
+
+   // appending sources in rank order leaves every out-list sorted
+   o->nV = nV;
+   o->offsets = calloc(nV + 1, sizeof(long));
+   assert(o->offsets != NULL);
+   for (Vertex v = 0; v < nV; v++)
+      for (long i = g->offsets[v]; i < g->offsets[v + 1]; i++)
+         if (rank[g->targets[i]] < rank[v])
+            o->offsets[rank[g->targets[i]] + 1]++;
+   o->maxOut = 0;
+   for (int r = 0; r < nV; r++) {
+      if (o->offsets[r + 1] > o->maxOut)
+         o->maxOut = o->offsets[r + 1];
+      o->offsets[r + 1] += o->offsets[r];
+   }
+   long nOut = o->offsets[nV];
+   long *fill = malloc((nV > 0 ? nV : 1) * sizeof(long));
+   o->targets = malloc((nOut > 0 ? nOut : 1) * sizeof(Vertex));
+   assert(fill != NULL && o->targets != NULL);
+   memcpy(fill, o->offsets, nV * sizeof(long));
+   for (int s = 0; s < nV; s++) {
+      Vertex u = o->order[s];
+      for (long i = g->offsets[u]; i < g->offsets[u + 1]; i++)
+         if (rank[g->targets[i]] < s)
+            o->targets[fill[rank[g->targets[i]]]++] = s;
+   }
+   free(fill);
+
+   // bitset rows pay off once a row scan is cheaper than merging two out-lists
+   o->bits = NULL;
+   o->rowWords = ((size_t)nV + 255) / 256 * 4;
+   if (nV > 0 && (double)nV * o->rowWords * 8 <= BITSET_BYTES
+       && o->rowWords <= 8 * (size_t)(nOut / nV)) {
+      o->bits = aligned_alloc(64, ((size_t)nV * o->rowWords * 8 + 63) / 64 * 64);
+      if (o->bits != NULL) {
+         memset(o->bits, 0, (size_t)nV * o->rowWords * 8);
+         for (int r = 0; r < nV; r++)
+            for (long i = o->offsets[r]; i < o->offsets[r + 1]; i++)
+               o->bits[r * o->rowWords + o->targets[i] / 64] |= 1ULL << (o->targets[i] % 64);
+      }
+   }
+
+   free(deg);
+   free(rank);
+   return o;
+}
+
+static void freeOriented(Oriented *o) {
+   free(o->order);
+   free(o->offsets);
+   free(o->targets);
+   free(o->bits);
+   free(o);
+}
+
+/* ---------- counting ---------- */
+
+typedef struct {
+   Oriented *o;
+   long     *counts;    // per-thread totals, one cache line apart
+   long     *perRank;   // per-rank triangle counts, or NULL
+   Vertex  **scratch;   // per-thread intersection buffers
+} CountJob;
+
+#define PAD (64 / sizeof(long))
+
+static void countRange(int lo, int hi, int thread, void *arg) {
+   CountJob *job = arg;
+   Oriented *o = job->o;
+   Vertex *common = job->perRank != NULL ? job->scratch[thread] : NULL;
+   long total = 0;
+
+   for (int r = lo; r < hi; r++) {
+      const Vertex *ru = o->targets + o->offsets[r];
+      long nu = o->offsets[r + 1] - o->offsets[r];
+      for (long i = 0; i < nu; i++) {
+         Vertex v = ru[i];
+         long c;
+         if (o->bits != NULL) {
+            // row v only holds ranks above v, so earlier words contribute nothing
+            const uint64_t *a = o->bits + r * o->rowWords, *b = o->bits + v * o->rowWords;
+            size_t from = (size_t)v / 256 * 4;
+            c = andCount(a, b, from, o->rowWords);
+            if (common != NULL) {
+               long k = 0;
+               for (size_t w = from; w < o->rowWords; w++)
+                  for (uint64_t m = a[w] & b[w]; m != 0; m &= m - 1)
+                     common[k++] = w * 64 + __builtin_ctzll(m);
+            }
+         } else {
+            // only out-list entries after v can close a triangle with v
+            c = intersectRows(ru + i + 1, nu - i - 1, o->targets + o->offsets[v],
+                          o->offsets[v + 1] - o->offsets[v], common);
+         }
+         total += c;
+         if (common != NULL && c > 0) {
+            __atomic_fetch_add(&job->perRank[r], c, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&job->perRank[v], c, __ATOMIC_RELAXED);
+            for (long k = 0; k < c; k++)
+               __atomic_fetch_add(&job->perRank[common[k]], 1, __ATOMIC_RELAXED);
+         }
+      }
+   }
+   job->counts[thread * PAD] += total;
+}
+
+long countTriangles(CSR *g, int nThreads, long *perVertex) {
+   assert(g != NULL);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+   Oriented *o = orient(g);
+
+   CountJob job = { .o = o, .perRank = NULL, .scratch = NULL };
+   job.counts = calloc(nThreads * PAD, sizeof(long));
+   assert(job.counts != NULL);
+   if (perVertex != NULL) {
+      job.perRank = calloc(o->nV > 0 ? o->nV : 1, sizeof(long));
+      job.scratch = malloc(nThreads * sizeof(Vertex *));
+      assert(job.perRank != NULL && job.scratch != NULL);
+      for (int t = 0; t < nThreads; t++) {
+         job.scratch[t] = malloc((o->maxOut + 8) * sizeof(Vertex));
+         assert(job.scratch[t] != NULL);
+      }
+   }
+
+   parallelFor(o->nV, CHUNK, nThreads, countRange, &job);
+
+   long total = 0;
+   for (int t = 0; t < nThreads; t++)
+      total += job.counts[t * PAD];
+   if (perVertex != NULL) {
+      for (int r = 0; r < o->nV; r++)
+         perVertex[o->order[r]] = job.perRank[r];
+      for (int t = 0; t < nThreads; t++)
+         free(job.scratch[t]);
+      free(job.scratch);
+      free(job.perRank);
+   }
+   free(job.counts);
+   freeOriented(o);
+   return total;
+}
+
+double *clusteringCoefficients(CSR *g, int nThreads) {
+   assert(g != NULL);
+   long *tri = malloc((g->nV > 0 ? g->nV : 1) * sizeof(long));
+   double *cc = malloc((g->nV > 0 ? g->nV : 1) * sizeof(double));
+   assert(tri != NULL && cc != NULL);
+
+   countTriangles(g, nThreads, tri);
+   for (Vertex v = 0; v < g->nV; v++) {
+      long d = 0;
+      for (long i = g->offsets[v]; i < g->offsets[v + 1]; i++)
+         d += g->targets[i] != v;
+      cc[v] = d < 2 ? 0.0 : 2.0 * tri[v] / ((double)d * (d - 1));
+   }
+   free(tri);
+   return cc;
+}
+
+/* ---------- listing ---------- */
+
+// listing works in vertex ids so triangles come out in (u, v, w) order;
+// chunks are filled in parallel and then handed to visit in chunk order
+typedef struct {
+   Vertex *tri;         // triples found in this chunk
+   long    n, cap;      // #triples stored, capacity in triples
+} Batch;
+
+typedef struct {
+   CSR     *g;
+   int      first;      // first vertex of this round
+   Batch   *batches;    // one per chunk of the round
+   Vertex **scratch;
+} ListJob;
+
+static void listRange(int lo, int hi, int thread, void *arg) {
+   ListJob *job = arg;
+   CSR *g = job->g;
+   Vertex *common = job->scratch[thread];
+   Batch *b = &job->batches[lo / CHUNK];
+   b->n = 0;
+
+   for (Vertex u = job->first + lo; u < job->first + hi; u++) {
+      long end = g->offsets[u + 1];
+      long i = lowerBoundRow(g->targets, g->offsets[u], end, u + 1);
+      for (; i < end; i++) {
+         Vertex v = g->targets[i];
+         long from = lowerBoundRow(g->targets, g->offsets[v], g->offsets[v + 1], v + 1);
+         long c = intersectRows(g->targets + i + 1, end - i - 1, g->targets + from,
+                            g->offsets[v + 1] - from, common);
+         if (b->n + c > b->cap) {
+            b->cap = 2 * (b->n + c);
+            b->tri = realloc(b->tri, b->cap * 3 * sizeof(Vertex));
+            assert(b->tri != NULL);
+         }
+         for (long k = 0; k < c; k++) {
+            b->tri[3 * b->n] = u;
+            b->tri[3 * b->n + 1] = v;
+            b->tri[3 * b->n + 2] = common[k];
+            b->n++;
+         }
+      }
+   }
+}
+
+void listTriangles(CSR *g, int nThreads, TriangleFn visit, void *arg) {
+   assert(g != NULL && visit != NULL);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+
+   long maxDeg = 0;
+   for (Vertex v = 0; v < g->nV; v++)
+      if (g->offsets[v + 1] - g->offsets[v] > maxDeg)
+         maxDeg = g->offsets[v + 1] - g->offsets[v];
+
+   int nBatches = nThreads * LIST_ROUND;
+   ListJob job = { .g = g };
+   job.batches = calloc(nBatches, sizeof(Batch));
+   job.scratch = malloc(nThreads * sizeof(Vertex *));
+   assert(job.batches != NULL && job.scratch != NULL);
+   for (int t = 0; t < nThreads; t++) {
+      job.scratch[t] = malloc((maxDeg + 8) * sizeof(Vertex));
+      assert(job.scratch[t] != NULL);
+   }
+
+   // bounded rounds keep buffered output proportional to the thread count
+   for (job.first = 0; job.first < g->nV; job.first += nBatches * CHUNK) {
+      int n = g->nV - job.first < nBatches * CHUNK ? g->nV - job.first : nBatches * CHUNK;
+      parallelFor(n, CHUNK, nThreads, listRange, &job);
+      for (int c = 0; c * CHUNK < n; c++)
+         for (long k = 0; k < job.batches[c].n; k++)
+            visit(job.batches[c].tri[3 * k], job.batches[c].tri[3 * k + 1],
+                  job.batches[c].tri[3 * k + 2], arg);
+   }
+
+   for (int t = 0; t < nThreads; t++)
+      free(job.scratch[t]);
+   for (int c = 0; c < nBatches; c++)
+      free(job.batches[c].tri);
+   free(job.scratch);
+   free(job.batches);
+}
@@ -0,0 +1,19 @@
+// Triangle engine: counting, listing and clustering over a CSR view
+#ifndef TRIANGLES_H
+#define TRIANGLES_H
+
+#include "CSR.h"
+
+// called once per triangle u < v < w
+typedef void (*TriangleFn)(Vertex u, Vertex v, Vertex w, void *arg);
+
+// #triangles; if perVertex != NULL it receives each vertex's triangle count
+long    countTriangles(CSR *, int nThreads, long *perVertex);
+
+// visit every triangle in lexicographic order of (u, v, w)
+void    listTriangles(CSR *, int nThreads, TriangleFn visit, void *arg);
+
+// local clustering coefficient of each vertex (loops ignored); caller frees
+double *clusteringCoefficients(CSR *, int nThreads);
+
+#endif
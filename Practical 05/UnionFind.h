@@ -0,0 +1,15 @@
+// Union-find ADT (disjoint sets of vertices 0..n-1)
+#ifndef UNIONFIND_H
+#define UNIONFIND_H
+
+#include <stdbool.h>
+
+typedef struct UFRep *UnionFind;
+
+UnionFind newUnionFind(int);
+int   ufFind(UnionFind, int);          // representative of the set holding v
+bool  ufUnion(UnionFind, int, int);    // merge two sets; false if already one set
+int   ufSets(UnionFind);               // #disjoint sets
+void  freeUnionFind(UnionFind);
+
+#endif
@@ -1,19 +1,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include "Graph.h"
+#include "UnionFind.h"
+#include "EdgeList.h"
 
 // DFS 輔助函數：返回 true 表示發現循環
 bool DFS(Graph g, int v, int parent, bool *visited, int n) {
     visited[v] = true;  // 標記當前節點為已訪問
-    for (int w = 0; w < n; w++) {
-        if (adjacent(g, v, w)) {  // 檢查 v 和 w 是否相鄰
-            if (!visited[w]) {  // 如果 w 未被訪問
-                if (DFS(g, w, v, visited, n))  // 遞歸訪問 w
-                    return true;  // 發現循環
-            } else if (w != parent) {  // 如果 w 已訪問且不是父節點
+    for (int w = firstNeighbour(g, v); w != -1; w = nextNeighbour(g, v, w)) {  // 只走訪 v 的鄰居
+        if (!visited[w]) {  // 如果 w 未被訪問
+            if (DFS(g, w, v, visited, n))  // 遞歸訪問 w
                 return true;  // 發現循環
-            }
+        } else if (w != parent) {  // 如果 w 已訪問且不是父節點
+            return true;  // 發現循環
         }
     }
     return false;  // 未發現循環
@@ -38,33 +39,167 @@ bool hasCycle(Graph g, int n) {
     return false;  // 未發現循環
 }
 
-int main(void) {
-    int n;
-    printf("Enter the number of vertices: ");
-    if (scanf("%d", &n) != 1 || n < 1) {
-        return EXIT_FAILURE;  // 無效的節點數量
+// 生成樹邊的雜湊集合：無環時最多 n-1 條邊，用來忽略重複輸入的邊
+typedef struct {
+    unsigned long long *keys;  // 0 為空位，否則為 (較小端點 << 32 | 較大端點) + 1
+    size_t mask;               // 容量 - 1（容量為 2 的冪）
+} EdgeSet;
+
+static unsigned long long edgeKey(int v, int w) {
+    if (v > w) {
+        int t = v; v = w; w = t;
     }
+    return ((unsigned long long)v << 32 | (unsigned)w) + 1;
+}
+
+// 查找邊的位置：返回存放該邊的槽位，或應插入的空槽位
+static size_t edgeSlot(EdgeSet *s, unsigned long long key) {
+    size_t i = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & s->mask;
+    while (s->keys[i] != 0 && s->keys[i] != key)
+        i = (i + 1) & s->mask;  // 線性探測
+    return i;
+}
+
+// 在線檢查的狀態：並查集加上生成樹邊的集合
+typedef struct {
+    UnionFind uf;
+    EdgeSet tree;
+} Online;
+
+static bool newOnline(Online *o, int n) {
+    size_t cap = 2;
+    while (cap < 2 * (size_t)n)  // 負載不超過一半
+        cap *= 2;
+    o->tree.keys = calloc(cap, sizeof(unsigned long long));
+    o->tree.mask = cap - 1;
+    if (o->tree.keys == NULL)
+        return false;  // 內存分配失敗
+    o->uf = newUnionFind(n);
+    return true;
+}
+
+static void freeOnline(Online *o) {
+    free(o->tree.keys);
+    freeUnionFind(o->uf);
+}
 
-    Graph g = newGraph(n);  // 創建圖
-    if (g == NULL) {
-        return EXIT_FAILURE;  // 創建圖失敗
+// 加入一條邊：返回 true 表示這條邊閉合了一個循環
+static bool closesCycle(Online *o, int from, int to) {
+    int rv = ufFind(o->uf, from), rw = ufFind(o->uf, to);  // 同時檢查頂點是否有效
+    if (rv != rw) {  // 連接兩個不同的連通分量：成為生成樹的邊
+        ufUnion(o->uf, rv, rw);
+        unsigned long long key = edgeKey(from, to);
+        o->tree.keys[edgeSlot(&o->tree, key)] = key;
+        return false;
     }
+    // 自環，或同一連通分量內的新邊會閉合循環；重複的生成樹邊則忽略
+    return from == to || o->tree.keys[edgeSlot(&o->tree, edgeKey(from, to))] == 0;
+}
+
+// 在線模式：邊一到達就用並查集判斷是否成環，不建立鄰接矩陣，O(m α(n))
+// el 為 NULL 時從標準輸入逐條讀取邊
+bool onlineCycleCheck(int n, const EdgeList *el) {
+    Online o;
+    if (!newOnline(&o, n))
+        return false;
 
-    // 讀取邊，直到遇到非數字輸入
+    bool cyclic = false;
     int from, to;
-    Edge e;
-    while (1) {
-        printf("Enter an edge (from): ");
-        if (scanf("%d", &from) != 1)
-            break;
-        printf("Enter an edge (to): ");
-        if (scanf("%d", &to) != 1)
-            break;
-        e.v = from;
-        e.w = to;
-        insertEdge(g, e);  // 插入邊
+    for (long i = 0; !cyclic; i++) {
+        if (el != NULL) {
+            if (i == el->nE)
+                break;
+            from = el->edges[i].v;
+            to = el->edges[i].w;
+        } else {
+            printf("Enter an edge (from): ");
+            if (scanf("%d", &from) != 1)
+                break;
+            printf("Enter an edge (to): ");
+            if (scanf("%d", &to) != 1)
+                break;
+        }
+        if (closesCycle(&o, from, to)) {
+            printf("Edge %d-%d closes a cycle.\n", from, to);  // 立即報告閉合循環的邊
+            cyclic = true;
+        }
+    }
+    if (!cyclic && el == NULL)
+        printf("Done.\n");
+
+    freeOnline(&o);
+    return cyclic;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-o] [-f file]\n", prog);
+    fprintf(stderr, "  -o  check each edge as it arrives and stop at the first cycle\n");
+    fprintf(stderr, "  -f  read a binary or text edge file (- for text on stdin), no prompts\n");
+}
+
+int main(int argc, char *argv[]) {
+    bool online = false;
+    const char *edgeFile = NULL;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "-o") == 0) {
+            online = true;  // 在線模式
+        } else if (strcmp(argv[a], "-f") == 0 && a + 1 < argc) {
+            edgeFile = argv[++a];  // 非交互式讀取邊
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    int n;
+    EdgeList el;
+    if (edgeFile != NULL) {
+        if (!loadEdgeList(edgeFile, 0, &el))
+            return EXIT_FAILURE;
+        n = el.nV;
+    } else {
+        printf("Enter the number of vertices: ");
+        if (scanf("%d", &n) != 1 || n < 1) {
+            return EXIT_FAILURE;  // 無效的節點數量
+        }
+    }
+
+    if (online) {
+        if (onlineCycleCheck(n, edgeFile != NULL ? &el : NULL))
+            printf("The graph has a cycle.\n");
+        else
+            printf("The graph is acyclic.\n");
+        if (edgeFile != NULL)
+            freeEdgeList(&el);
+        return EXIT_SUCCESS;
+    }
+
+    Graph g;
+    if (edgeFile != NULL) {
+        g = newGraphFromEdges(n, el.edges, el.nE, 0);  // 並行批量建圖
+        freeEdgeList(&el);
+    } else {
+        g = newGraph(n);  // 創建圖
+        if (g == NULL) {
+            return EXIT_FAILURE;  // 創建圖失敗
+        }
+
+        // 讀取邊，直到遇到非數字輸入
+        int from, to;
+        Edge e;
+        while (1) {
+            printf("Enter an edge (from): ");
+            if (scanf("%d", &from) != 1)
+                break;
+            printf("Enter an edge (to): ");
+            if (scanf("%d", &to) != 1)
+                break;
+            e.v = from;
+            e.w = to;
+            insertEdge(g, e);  // 插入邊
+        }
+        printf("Done.\n");
     }
-    printf("Done.\n");
 
     // 檢查圖是否有循環
     if (hasCycle(g, n))
@@ -74,4 +209,4 @@ int main(void) {
 
     freeGraph(g);  // 釋放圖的內存
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -1,38 +1,95 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
 #include "Graph.h"
+#include "CSR.h"
+#include "Triangles.h"
+#include "Cliques.h"
+#include "BFS.h"
+#include "Betweenness.h"
+#include "EdgeList.h"
+#include "Reorder.h"
+
+// the graph the kernels run on, possibly renumbered for locality
+typedef struct {
+    CSR* csr;
+    Vertex* oldOf;  // node id of each vertex of csr, NULL if not renumbered
+    Vertex* newOf;  // vertex of csr for each node id, NULL if not renumbered
+} Work;
 
 int* calculateDegrees(Graph g, int n) {
-    int* degree = calloc(n, sizeof(int));
-    if (degree == NULL) {
+    int* degrees = calloc(n, sizeof(int));
+    if (degrees == NULL) {
         fprintf(stderr, "Memory allocation error.\n");
         return NULL;
     }
 
     for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (adjacent(g, i, j)) {
-                degree[i]++;
-            }
-        }
+        degrees[i] = degree(g, i);
     }
-    return degree;
+    return degrees;
 }
 
-void findAndPrint3Cliques(Graph g, int n) {
+static void printTriangle(Vertex i, Vertex j, Vertex k, void *arg) {
+    (void)arg;
+    printf("%d-%d-%d\n", i, j, k);
+}
+
+void findAndPrint3Cliques(CSR* csr, int threads, bool countOnly) {
+    if (countOnly) {
+        printf("3-cliques: %ld\n", countTriangles(csr, threads, NULL));
+        return;
+    }
     printf("3-cliques:\n");
+    listTriangles(csr, threads, printTriangle, NULL);
+}
 
-    for (int i = 0; i < n - 2; i++) {
-        for (int j = i + 1; j < n - 1; j++) {
-            if (!adjacent(g, i, j))
-                continue;
-            for (int k = j + 1; k < n; k++) {
-                if (adjacent(g, i, k) && adjacent(g, j, k)) {
-                    printf("%d-%d-%d\n", i, j, k);
-                }
-            }
-        }
+static int compareVertex(const void* a, const void* b) {
+    Vertex x = *(const Vertex*)a, y = *(const Vertex*)b;
+    return (x > y) - (x < y);
+}
+
+// cliques come from the work graph; print them in node ids, ascending
+static void printClique(const Vertex* clique, int size, void *arg) {
+    const Vertex* oldOf = arg;
+    Vertex nodes[size];
+    for (int i = 0; i < size; i++) {
+        nodes[i] = oldOf != NULL ? oldOf[clique[i]] : clique[i];
+    }
+    if (oldOf != NULL) {
+        qsort(nodes, size, sizeof(Vertex), compareVertex);
+    }
+    for (int i = 0; i < size; i++) {
+        printf(i == 0 ? "%d" : "-%d", nodes[i]);
+    }
+    printf("\n");
+}
+
+void findAndPrintKCliques(Work* w, int k, int threads, bool countOnly) {
+    if (countOnly) {
+        printf("%d-cliques: %ld\n", k, kCliques(w->csr, k, threads, NULL, NULL));
+        return;
+    }
+    printf("%d-cliques:\n", k);
+    kCliques(w->csr, k, threads, printClique, w->oldOf);
+}
+
+void findAndPrintMaximalCliques(Work* w, int threads, bool countOnly) {
+    if (countOnly) {
+        printf("Maximal cliques: %ld\n", maximalCliques(w->csr, threads, NULL, NULL));
+        return;
     }
+    printf("Maximal cliques:\n");
+    maximalCliques(w->csr, threads, printClique, w->oldOf);
+}
+
+void printClustering(Work* w, int threads) {
+    double* cc = clusteringCoefficients(w->csr, threads);
+    for (int i = 0; i < w->csr->nV; i++) {
+        printf("Clustering of node %d: %.3f\n", i, cc[w->newOf != NULL ? w->newOf[i] : i]);
+    }
+    free(cc);
 }
 
 double calculateDensity(int* degree, int n) {
@@ -44,34 +101,171 @@ double calculateDensity(int* degree, int n) {
     return (2.0 * numEdges) / (n * n);
 }
 
-int main(void) {
-    int n;
-    printf("Enter the number of vertices: ");
-    if (scanf("%d", &n) != 1 || n < 1) {
-        fprintf(stderr, "Invalid number of vertices.\n");
-        return EXIT_FAILURE;
+// the parent shown is the lowest node id one hop nearer the source, so it
+// does not depend on the thread count or on -r
+void printHops(Work* w, int src, int threads) {
+    CSR* csr = w->csr;
+    int n = csr->nV;
+    int* level = malloc(n * sizeof(int));
+    if (level == NULL) {
+        fprintf(stderr, "Memory allocation error.\n");
+        return;
     }
 
-    Graph g = newGraph(n);
-    if (g == NULL) {
-        fprintf(stderr, "Failed to create graph.\n");
-        return EXIT_FAILURE;
+    bfs(csr, w->newOf != NULL ? w->newOf[src] : src, threads, level, NULL);
+    printf("Hops from node %d:\n", src);
+    for (int i = 0; i < n; i++) {
+        int v = w->newOf != NULL ? w->newOf[i] : i;
+        if (level[v] < 0) {
+            printf("Node %d: unreachable\n", i);
+            continue;
+        }
+        int via = i;
+        for (long k = csr->offsets[v]; k < csr->offsets[v + 1]; k++) {
+            Vertex u = csr->targets[k];
+            int node = w->oldOf != NULL ? w->oldOf[u] : u;
+            if (level[u] == level[v] - 1 && (via == i || node < via)) {
+                via = node;
+            }
+        }
+        printf("Node %d: %d (via %d)\n", i, level[v], via);
+    }
+    free(level);
+}
+
+void printBetweenness(Work* w, int top, int samples, int threads) {
+    int n = w->csr->nV;
+    double* bc = malloc(n * sizeof(double));
+    double* byNode = malloc(n * sizeof(double));
+    Vertex* best = malloc(n * sizeof(Vertex));
+    if (bc == NULL || byNode == NULL || best == NULL) {
+        fprintf(stderr, "Memory allocation error.\n");
+        free(bc);
+        free(byNode);
+        free(best);
+        return;
+    }
+
+    betweenness(w->csr, samples, 1, threads, bc);
+    for (int i = 0; i < n; i++) {
+        byNode[i] = bc[w->newOf != NULL ? w->newOf[i] : i];
+    }
+    int shown = topBetweenness(byNode, n, top, best);
+    if (samples > 0 && samples < n) {
+        printf("Betweenness (estimated from %d sources):\n", samples);
+    } else {
+        printf("Betweenness:\n");
+    }
+    for (int i = 0; i < shown; i++) {
+        printf("Node %d: %.3f\n", best[i], byNode[best[i]]);
     }
+    free(bc);
+    free(byNode);
+    free(best);
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [-f file] [-c] [-k size] [-m] [-l] [-b node] [-e top] [-a samples] [-r order] [-s] [-t threads]\n", prog);
+    fprintf(stderr, "  -f  read a binary or text edge file (- for text on stdin), no prompts\n");
+    fprintf(stderr, "  -c  print clique counts instead of listing the cliques\n");
+    fprintf(stderr, "  -k  also find all cliques with the given number of nodes\n");
+    fprintf(stderr, "  -m  also find all maximal cliques\n");
+    fprintf(stderr, "  -l  print the local clustering coefficient of each node\n");
+    fprintf(stderr, "  -b  print hop distances from the given node, each via its lowest-numbered\n");
+    fprintf(stderr, "      neighbour one hop nearer\n");
+    fprintf(stderr, "  -e  print the given number of nodes of highest betweenness centrality\n");
+    fprintf(stderr, "  -a  estimate betweenness from this many sampled source nodes\n");
+    fprintf(stderr, "  -r  renumber nodes internally (rcm, degree or bfs) and print bandwidth;\n");
+    fprintf(stderr, "      results keep the input ids, but -k and -m may list in another order\n");
+    fprintf(stderr, "  -s  print how the graph is stored and the memory it uses\n");
+    fprintf(stderr, "  -t  number of worker threads (default: all CPUs);\n");
+    fprintf(stderr, "      with more than one, -k and -m list cliques in no fixed order\n");
+}
+
+int main(int argc, char* argv[]) {
+    bool countOnly = false, clustering = false, maximal = false, stats = false;
+    int threads = 0, cliqueSize = 0, bfsSource = -1, topCentral = 0, samples = 0;
+    const char* edgeFile = NULL;
+    bool reorder = false;
+    Ordering ordering = ORDER_RCM;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "-f") == 0 && a + 1 < argc) {
+            edgeFile = argv[++a];
+        } else if (strcmp(argv[a], "-c") == 0) {
+            countOnly = true;
+        } else if (strcmp(argv[a], "-m") == 0) {
+            maximal = true;
+        } else if (strcmp(argv[a], "-k") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0) {
+            cliqueSize = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-b") == 0 && a + 1 < argc && atoi(argv[a + 1]) >= 0) {
+            bfsSource = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-e") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0) {
+            topCentral = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-a") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0) {
+            samples = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-r") == 0 && a + 1 < argc) {
+            reorder = true;
+            a++;
+            if (strcmp(argv[a], "rcm") == 0) {
+                ordering = ORDER_RCM;
+            } else if (strcmp(argv[a], "degree") == 0) {
+                ordering = ORDER_DEGREE;
+            } else if (strcmp(argv[a], "bfs") == 0) {
+                ordering = ORDER_BFS;
+            } else {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[a], "-l") == 0) {
+            clustering = true;
+        } else if (strcmp(argv[a], "-s") == 0) {
+            stats = true;
+        } else if (strcmp(argv[a], "-t") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0) {
+            threads = atoi(argv[++a]);
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    int n;
+    Graph g;
+    if (edgeFile != NULL) {
+        EdgeList el;
+        if (!loadEdgeList(edgeFile, threads, &el)) {
+            return EXIT_FAILURE;
+        }
+        n = el.nV;
+        g = newGraphFromEdges(n, el.edges, el.nE, threads);
+        freeEdgeList(&el);
+    } else {
+        printf("Enter the number of vertices: ");
+        if (scanf("%d", &n) != 1 || n < 1) {
+            fprintf(stderr, "Invalid number of vertices.\n");
+            return EXIT_FAILURE;
+        }
+
+        g = newGraph(n);
+        if (g == NULL) {
+            fprintf(stderr, "Failed to create graph.\n");
+            return EXIT_FAILURE;
+        }
 
-    int from, to;
-    Edge e;
-    while (1) {
-        printf("Enter an edge (from): ");
-        if (scanf("%d", &from) != 1)
-            break;
-        printf("Enter an edge (to): ");
-        if (scanf("%d", &to) != 1)
-            break;
-        e.v = from;
-        e.w = to;
-        insertEdge(g, e);
+        int from, to;
+        Edge e;
+        while (1) {
+            printf("Enter an edge (from): ");
+            if (scanf("%d", &from) != 1)
+                break;
+            printf("Enter an edge (to): ");
+            if (scanf("%d", &to) != 1)
+                break;
+            e.v = from;
+            e.w = to;
+            insertEdge(g, e);
+        }
+        printf("Done.\n");
     }
-    printf("Done.\n");
 
     int* degree = calculateDegrees(g, n);
     if (degree == NULL) {
@@ -82,8 +276,47 @@ int main(void) {
     for (int i = 0; i < n; i++) {
         printf("Degree of node %d: %d\n", i, degree[i]);
     }
+    if (stats) {
+        GraphStats s = graphStats(g);
+        printf("Representation: %s, %zu bytes\n", s.dense ? "matrix" : "arrays", s.bytes);
+    }
+
+    CSR* csr = newCSR(g);
+    Work work = { csr, NULL, NULL };
+    if (reorder) {
+        work.oldOf = vertexOrdering(csr, ordering);
+        work.newOf = invertOrdering(work.oldOf, n);
+        work.csr = permuteCSR(csr, work.oldOf, work.newOf, threads);
+        printf("Bandwidth: %ld -> %ld\n", bandwidth(csr), bandwidth(work.csr));
+    }
 
-    findAndPrint3Cliques(g, n);
+    // listing walks the original numbering so triangles print in id order
+    findAndPrint3Cliques(countOnly ? work.csr : csr, threads, countOnly);
+    if (cliqueSize > 0) {
+        findAndPrintKCliques(&work, cliqueSize, threads, countOnly);
+    }
+    if (maximal) {
+        findAndPrintMaximalCliques(&work, threads, countOnly);
+    }
+    if (clustering) {
+        printClustering(&work, threads);
+    }
+    if (bfsSource >= 0) {
+        if (bfsSource < n) {
+            printHops(&work, bfsSource, threads);
+        } else {
+            fprintf(stderr, "Invalid BFS source node.\n");
+        }
+    }
+    if (topCentral > 0) {
+        printBetweenness(&work, topCentral, samples, threads);
+    }
+    if (reorder) {
+        freeCSR(work.csr);
+        free(work.oldOf);
+        free(work.newOf);
+    }
+    freeCSR(csr);
 
     double density = calculateDensity(degree, n);
     printf("Density: %.3f\n", density);
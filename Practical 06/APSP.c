@@ -0,0 +1,233 @@
+// All-pairs shortest paths over a WCSR view
+//
+// Floyd-Warshall runs on TILE x TILE blocks (Venkataraman et al.): for each
+// diagonal block k it closes block (k,k), then the rest of block row and
+// column k against it, then every other block against those, the last two
+// steps in parallel across blocks.  Every update is a min-plus row kernel,
+// c[j] = min(c[j], a + b[j]), eight lanes at a time with AVX2.
+// Sparse graphs instead run one heap Dijkstra per source, sources in parallel.
+#define _POSIX_C_SOURCE 200809L
+#include "APSP.h"
+#include "PQueue.h"
+#include "Parallel.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define TILE 64                // rows and columns per block (16KB of int32)
+#define SIMD_LANES 8           // int32 per kernel step
+
+typedef struct {
+   const WCSR *g;
+   int32_t    *d;
+   int         n;              // #vertices = row length of d
+   int         nTiles;         // #blocks per row
+   int         k;              // current diagonal block
+   PQueue     *queue;          // Dijkstra: per thread
+} Apsp;
+
+/* ---------- Floyd-Warshall ---------- */
+
+// c[j] = min(c[j], a + b[j]) for j < n; a < APSP_NO_PATH
+static void minPlusRow(int32_t *c, const int32_t *b, int32_t a, int n) {
+   int j = 0;
+#ifdef __AVX2__
+   __m256i va = _mm256_set1_epi32(a);
+   for (; j + SIMD_LANES <= n; j += SIMD_LANES) {
+      __m256i s = _mm256_add_epi32(va, _mm256_loadu_si256((const __m256i *)(b + j)));
+      __m256i m = _mm256_min_epi32(s, _mm256_loadu_si256((const __m256i *)(c + j)));
+      _mm256_storeu_si256((__m256i *)(c + j), m);
+   }
+#endif
+   for (; j < n; j++)
+      if (a + b[j] < c[j])
+         c[j] = a + b[j];
+}
+
+static int tileEnd(const Apsp *s, int t) {
+   return (t + 1) * TILE < s->n ? (t + 1) * TILE : s->n;
+}
+
+// relax block (ti,tj) through the vertices of block tk; k outermost, as
+// needed when the block is one of its own inputs
+static void closeTile(const Apsp *s, int ti, int tj, int tk) {
+   int32_t *d = s->d;
+   size_t n = s->n;
+   int c0 = tj * TILE, width = tileEnd(s, tj) - c0;
+   for (int k = tk * TILE; k < tileEnd(s, tk); k++)
+      for (int i = ti * TILE; i < tileEnd(s, ti); i++)
+         if (d[i * n + k] < APSP_NO_PATH)
+            minPlusRow(d + i * n + c0, d + k * n + c0, d[i * n + k], width);
+}
+
+// relax block (ti,tj) through block tk when it is not one of its inputs;
+// rows outermost so each row of the block stays in cache
+static void updateTile(const Apsp *s, int ti, int tj, int tk) {
+   int32_t *d = s->d;
+   size_t n = s->n;
+   int c0 = tj * TILE, width = tileEnd(s, tj) - c0;
+   for (int i = ti * TILE; i < tileEnd(s, ti); i++)
+      for (int k = tk * TILE; k < tileEnd(s, tk); k++)
+         if (d[i * n + k] < APSP_NO_PATH)
+            minPlusRow(d + i * n + c0, d + k * n + c0, d[i * n + k], width);
+}
+
+// blocks 0..nTiles-1 of row k, then nTiles..2*nTiles-1 of column k
+static void crossTiles(int lo, int hi, int thread, void *arg) {
+   Apsp *s = arg;
+   for (int t = lo; t < hi; t++) {
+      int other = t % s->nTiles;
+      if (other == s->k)
+         continue;
+      if (t < s->nTiles)
+         closeTile(s, s->k, other, s->k);
+      else
+         closeTile(s, other, s->k, s->k);
+   }
+}
+
+static void otherTiles(int lo, int hi, int thread, void *arg) {
+   Apsp *s = arg;
+   for (int t = lo; t < hi; t++) {
+      int ti = t / s->nTiles, tj = t % s->nTiles;
+      if (ti != s->k && tj != s->k)
+         updateTile(s, ti, tj, s->k);
+   }
+}
+
+static void floydWarshall(Apsp *s, int nThreads) {
+   size_t n = s->n;
+   const WCSR *g = s->g;
+   for (size_t i = 0; i < n * n; i++)
+      s->d[i] = APSP_NO_PATH;
+   for (size_t u = 0; u < n; u++) {
+      s->d[u * n + u] = 0;
+      for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++)
+         if (g->weights[e] > 0 && g->weights[e] < s->d[u * n + g->targets[e]])
+            s->d[u * n + g->targets[e]] = g->weights[e];
+   }
+
+   s->nTiles = (s->n + TILE - 1) / TILE;
+   for (s->k = 0; s->k < s->nTiles; s->k++) {
+      closeTile(s, s->k, s->k, s->k);
+      parallelFor(2 * s->nTiles, 1, nThreads, crossTiles, s);
+      parallelFor(s->nTiles * s->nTiles, 1, nThreads, otherTiles, s);
+   }
+}
+
+/* ---------- repeated Dijkstra ---------- */
+
+static void dijkstraRows(int lo, int hi, int thread, void *arg) {
+   Apsp *s = arg;
+   const WCSR *g = s->g;
+   PQueue q = s->queue[thread];
+   for (Vertex src = lo; src < hi; src++) {
+      int32_t *dist = s->d + (size_t)src * s->n;
+      for (int v = 0; v < s->n; v++)
+         dist[v] = APSP_NO_PATH;
+      dist[src] = 0;
+      pqJoin(q, src, 0);
+      while (!pqIsEmpty(q)) {
+         Vertex u = pqLeave(q);
+         for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+            Vertex v = g->targets[e];
+            int64_t alt = (int64_t)dist[u] + g->weights[e];
+            if (g->weights[e] <= 0 || alt >= dist[v])
+               continue;
+            if (pqContains(q, v))
+               decreaseKey(q, v, alt);
+            else
+               pqJoin(q, v, alt);    // not yet settled, as settled distances are final
+            dist[v] = alt;
+         }
+      }
+   }
+}
+
+static void repeatedDijkstra(Apsp *s, int nThreads) {
+   s->queue = malloc(nThreads * sizeof(PQueue));
+   assert(s->queue != NULL);
+   for (int t = 0; t < nThreads; t++)
+      s->queue[t] = newPQueue(s->n);
+   parallelFor(s->n, 1, nThreads, dijkstraRows, s);
+   for (int t = 0; t < nThreads; t++)
+      dropPQueue(s->queue[t]);
+   free(s->queue);
+}
+
+/* ---------- interface ---------- */
+
+ApspMethod allPairs(WCSR *g, ApspMethod method, int nThreads, int32_t *d) {
+   assert(g != NULL && d != NULL);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+
+   // Dijkstra costs about E log V per source, Floyd-Warshall V^2 / SIMD_LANES
+   if (method == APSP_AUTO)
+      method = g->nE * log2(g->nV + 1.0) * SIMD_LANES < (double)g->nV * g->nV
+             ? APSP_DIJKSTRA : APSP_FLOYD;
+
+   Apsp s = { g, d, g->nV, 0, 0, NULL };
+   if (method == APSP_DIJKSTRA)
+      repeatedDijkstra(&s, nThreads);
+   else
+      floydWarshall(&s, nThreads);
+   return method;
+}
+
+bool newDistMatrix(int nV, const char *path, DistMatrix *out) {
+   assert(nV >= 0 && out != NULL);
+   size_t cells = (size_t)nV * nV;
+   out->nV = nV;
+   out->map = NULL;
+   out->mapLen = 0;
+
+   if (path == NULL) {
+      out->d = malloc((cells > 0 ? cells : 1) * sizeof(int32_t));
+      if (out->d == NULL) {
+         fprintf(stderr, "Memory allocation error.\n");
+         return false;
+      }
+      return true;
+   }
+
+   size_t len = sizeof(DistFileHeader) + cells * sizeof(int32_t);
+   int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+   if (fd < 0 || ftruncate(fd, len) != 0) {
+      perror(path);
+      if (fd >= 0)
+         close(fd);
+      return false;
+   }
+   void *map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   close(fd);
+   if (map == MAP_FAILED) {
+      perror(path);
+      return false;
+   }
+
+   DistFileHeader *h = map;
+   memcpy(h->magic, DIST_FILE_MAGIC, sizeof h->magic);
+   h->nV = nV;
+   out->d = (int32_t *)(h + 1);
+   out->map = map;
+   out->mapLen = len;
+   return true;
+}
+
+void freeDistMatrix(DistMatrix *m) {
+   assert(m != NULL);
+   if (m->map != NULL)
+      munmap(m->map, m->mapLen);       // a shared mapping writes back to the file
+   else
+      free(m->d);
+   m->d = NULL;
+}
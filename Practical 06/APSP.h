@@ -0,0 +1,41 @@
+// All-pairs shortest paths over a WCSR view
+//
+// Distance files start with a DistFileHeader followed by nV rows of nV int32
+// distances in host byte order, row u holding the distances from u; they are
+// written through a memory map.
+#ifndef APSP_H
+#define APSP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "WCSR.h"
+
+#define APSP_NO_PATH 0x3fffffff    // no path; paths this long or longer read the same
+#define DIST_FILE_MAGIC "APD1"
+
+typedef enum { APSP_AUTO, APSP_FLOYD, APSP_DIJKSTRA } ApspMethod;
+
+typedef struct DistFileHeader {
+   char     magic[4];   // DIST_FILE_MAGIC, no terminating '\0'
+   uint32_t nV;         // #vertices
+} DistFileHeader;
+
+typedef struct DistMatrix {
+   int      nV;
+   int32_t *d;          // d[(size_t)u * nV + v] = distance from u to v
+   void    *map;        // mapped file, or NULL if d is on the heap
+   size_t   mapLen;
+} DistMatrix;
+
+// fill the nV x nV matrix d; edges with weight <= 0 are ignored as in
+// dijkstraSSSP.  APSP_AUTO runs repeated Dijkstra on sparse graphs and tiled
+// Floyd-Warshall otherwise; returns the method used
+ApspMethod allPairs(WCSR *, ApspMethod, int nThreads, int32_t *d);
+
+// matrix on the heap (path NULL) or in a new file mapped into memory;
+// on failure reports on stderr, returns false
+bool newDistMatrix(int nV, const char *path, DistMatrix *out);
+void freeDistMatrix(DistMatrix *);
+
+#endif
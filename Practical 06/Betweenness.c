@@ -0,0 +1,179 @@
+// Betweenness centrality over a WCSR view
+//
+// Brandes' algorithm with Dijkstra: the search from each source counts the
+// shortest paths sigma[v] to every vertex, then the vertices are revisited
+// in the reverse of the order they were settled, and each takes
+// delta[v] = sum of sigma[v] / sigma[w] * (1 + delta[w]) over the out-edges
+// v -> w on a shortest path.  delta[v] is the source's dependency on v and
+// is added to v's score; (1 + delta[w]) / sigma[w] is kept instead of
+// delta[w] so the inner loop does not divide.  Sources are spread over the
+// threads; each thread owns its queue, its search arrays and its own score
+// array, and the score arrays are summed once all sources are done.
+#include "Betweenness.h"
+#include "PQueue.h"
+#include "Parallel.h"
+#include "Sort.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define UNREACHED INT_MAX
+#define SOURCE_CHUNK 1       // sources claimed at a time, each a whole search
+#define VERTEX_CHUNK 4096    // vertices per step when summing the scores
+
+typedef struct {
+   PQueue  q;
+   int    *dist;             // from the source, UNREACHED if not reached
+   double *sigma;            // #shortest paths from the source
+   double *share;            // (1 + dependency of the source on v) / sigma[v]
+   Vertex *order;            // vertices in the order they were settled
+   double *score;            // this thread's sum of dependencies
+} Scratch;
+
+typedef struct {
+   const WCSR   *g;
+   const Vertex *sources;    // NULL: every vertex
+   Scratch      *scratch;    // per thread
+   int           nThreads;
+   double        scale;
+   double       *bc;
+} Brandes;
+
+static void fromSource(const WCSR *g, Vertex s, Scratch *w) {
+   int n = 0;
+   w->dist[s] = 0;
+   w->sigma[s] = 1;
+   pqJoin(w->q, s, 0);
+   while (!pqIsEmpty(w->q)) {
+      Vertex u = pqLeave(w->q);
+      w->order[n++] = u;
+      for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+         Vertex v = g->targets[e];
+         if (g->weights[e] <= 0)
+            continue;
+         long alt = (long)w->dist[u] + g->weights[e];
+         if (alt < w->dist[v]) {
+            w->sigma[v] = w->sigma[u];       // u is settled, its count final
+            if (w->dist[v] == UNREACHED)
+               pqJoin(w->q, v, alt);
+            else
+               decreaseKey(w->q, v, alt);
+            w->dist[v] = alt;
+         } else if (alt == w->dist[v]) {
+            w->sigma[v] += w->sigma[u];
+         }
+      }
+   }
+
+   // order[0] is s, which gets no score
+   for (int i = n - 1; i > 0; i--) {
+      Vertex v = w->order[i];
+      double d = 0;
+      for (long e = g->offsets[v]; e < g->offsets[v + 1]; e++) {
+         Vertex u = g->targets[e];
+         if (g->weights[e] > 0 && (long)w->dist[v] + g->weights[e] == w->dist[u])
+            d += w->share[u];
+      }
+      double delta = w->sigma[v] * d;
+      w->score[v] += delta;
+      w->share[v] = (1 + delta) / w->sigma[v];
+   }
+   for (int i = 0; i < n; i++)
+      w->dist[w->order[i]] = UNREACHED;
+}
+
+static void sourceRange(int lo, int hi, int thread, void *arg) {
+   Brandes *b = arg;
+   for (int i = lo; i < hi; i++)
+      fromSource(b->g, b->sources != NULL ? b->sources[i] : i, &b->scratch[thread]);
+}
+
+static void sumRange(int lo, int hi, int thread, void *arg) {
+   Brandes *b = arg;
+   for (Vertex v = lo; v < hi; v++) {
+      double s = 0;
+      for (int t = 0; t < b->nThreads; t++)
+         s += b->scratch[t].score[v];
+      b->bc[v] = s * b->scale;
+   }
+}
+
+// k distinct vertices: the first k of a partial Fisher-Yates shuffle
+static Vertex *drawSources(int nV, int k, unsigned seed) {
+   Vertex *all = malloc(nV * sizeof(Vertex));
+   assert(all != NULL);
+   for (Vertex v = 0; v < nV; v++)
+      all[v] = v;
+   uint32_t x = seed != 0 ? seed : 2463534242u;
+   for (int i = 0; i < k; i++) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      int j = i + (int)(x % (uint32_t)(nV - i));
+      Vertex t = all[i];
+      all[i] = all[j];
+      all[j] = t;
+   }
+   return all;
+}
+
+void betweenness(WCSR *g, int samples, unsigned seed, int nThreads, double *bc) {
+   assert(g != NULL && bc != NULL);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+   int nV = g->nV;
+   bool sampled = samples > 0 && samples < nV;
+   int nSources = sampled ? samples : nV;
+
+   Brandes b = { .g = g, .nThreads = nThreads, .bc = bc };
+   b.sources = sampled ? drawSources(nV, samples, seed) : NULL;
+   b.scale = (double)nV / (nSources > 0 ? nSources : 1);
+   b.scratch = malloc(nThreads * sizeof(Scratch));
+   assert(b.scratch != NULL);
+   for (int t = 0; t < nThreads; t++) {
+      Scratch *w = &b.scratch[t];
+      w->q = newPQueue(nV);
+      w->dist = malloc((nV > 0 ? nV : 1) * sizeof(int));
+      w->sigma = malloc((nV > 0 ? nV : 1) * sizeof(double));
+      w->share = malloc((nV > 0 ? nV : 1) * sizeof(double));
+      w->order = malloc((nV > 0 ? nV : 1) * sizeof(Vertex));
+      w->score = calloc(nV > 0 ? nV : 1, sizeof(double));
+      assert(w->dist != NULL && w->sigma != NULL && w->share != NULL
+             && w->order != NULL && w->score != NULL);
+      for (Vertex v = 0; v < nV; v++)
+         w->dist[v] = UNREACHED;
+   }
+
+   parallelFor(nSources, SOURCE_CHUNK, nThreads, sourceRange, &b);
+   parallelFor(nV, VERTEX_CHUNK, nThreads, sumRange, &b);
+
+   for (int t = 0; t < nThreads; t++) {
+      dropPQueue(b.scratch[t].q);
+      free(b.scratch[t].dist);
+      free(b.scratch[t].sigma);
+      free(b.scratch[t].share);
+      free(b.scratch[t].order);
+      free(b.scratch[t].score);
+   }
+   free(b.scratch);
+   free((Vertex *)b.sources);
+}
+
+int topBetweenness(const double *bc, int nV, int k, Vertex *top) {
+   assert(bc != NULL && top != NULL);
+   if (k > nV)
+      k = nV;
+   if (k <= 0)
+      return 0;
+   KeyIndex *order = malloc(nV * sizeof(KeyIndex));
+   assert(order != NULL);
+   for (Vertex v = 0; v < nV; v++)
+      order[v] = (KeyIndex){ ~doubleKey(bc[v]), v };
+   sortKeyIndex(order, nV, 1);
+   for (int i = 0; i < k; i++)
+      top[i] = order[i].index;
+   free(order);
+   return k;
+}
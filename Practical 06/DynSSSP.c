@@ -0,0 +1,288 @@
+// Dynamic single-source shortest paths (Ramalingam & Reps)
+//
+// A cheaper or new edge u -> v can only shorten paths through v: Dijkstra
+// restarts from v with its new distance and stops where nothing improves.
+// A dearer or removed edge on a shortest path first marks, in order of
+// distance, the vertices left with no tight in-edge from an unmarked
+// vertex; only these lose their distance, which is rebuilt by Dijkstra
+// seeded with their best in-edge from the rest of the graph.  Predecessors
+// are then recomputed for every vertex whose in-edges or their tails
+// changed, so they do not depend on the order of the repairs.
+#include "DynSSSP.h"
+#include <assert.h>
+#include <stdlib.h>
+
+/* ---------- edge lists ---------- */
+
+static void addArc(DynArcList *l, Vertex v, int weight) {
+   if (l->n == l->cap) {
+      l->cap = l->cap > 0 ? 2 * l->cap : 4;
+      l->arcs = realloc(l->arcs, l->cap * sizeof(DynArc));
+      assert(l->arcs != NULL);
+   }
+   l->arcs[l->n++] = (DynArc){ v, weight };
+}
+
+// index of the arc to v in l, or -1
+static int findArc(const DynArcList *l, Vertex v) {
+   for (int i = 0; i < l->n; i++)
+      if (l->arcs[i].v == v)
+         return i;
+   return -1;
+}
+
+// add the arc to v, or change its weight
+static void setArc(DynArcList *l, Vertex v, int weight) {
+   int i = findArc(l, v);
+   if (i >= 0)
+      l->arcs[i].weight = weight;
+   else
+      addArc(l, v, weight);
+}
+
+static void dropArc(DynArcList *l, Vertex v) {
+   int i = findArc(l, v);
+   if (i >= 0)
+      l->arcs[i] = l->arcs[--l->n];
+}
+
+/* ---------- predecessors ---------- */
+
+// remember v's dist and pred before either changes
+static void touch(DynSSSP *d, Vertex v) {
+   if (!d->seen[v]) {
+      d->seen[v] = true;
+      d->touched[d->nTouched++] = (Touched){ v, d->dist[v], d->pred[v] };
+   }
+}
+
+// is u -> v (weight w) on a shortest path to v?
+static bool tight(const DynSSSP *d, Vertex u, Vertex v, int w) {
+   return w > 0 && d->dist[u] != DYN_NO_PATH && (long)d->dist[u] + w == d->dist[v];
+}
+
+// lowest (dist[u], u) over the tight in-edges of v, or -1
+static Vertex bestPred(const DynSSSP *d, Vertex v) {
+   Vertex best = -1;
+   if (v == d->src || d->dist[v] == DYN_NO_PATH)
+      return -1;
+   const DynArcList *l = &d->in[v];
+   for (int i = 0; i < l->n; i++) {
+      Vertex u = l->arcs[i].v;
+      if (tight(d, u, v, l->arcs[i].weight)
+          && (best < 0 || d->dist[u] < d->dist[best] || (d->dist[u] == d->dist[best] && u < best)))
+         best = u;
+   }
+   return best;
+}
+
+// recompute pred of the touched vertices; returns how many changed dist or pred
+static int settle(DynSSSP *d) {
+   int changed = 0;
+   for (int i = 0; i < d->nTouched; i++) {
+      Touched t = d->touched[i];
+      d->pred[t.v] = bestPred(d, t.v);
+      d->seen[t.v] = false;
+      if (d->dist[t.v] != t.dist || d->pred[t.v] != t.pred)
+         changed++;
+   }
+   d->nTouched = 0;
+   return changed;
+}
+
+/* ---------- repairs ---------- */
+
+// Dijkstra from the queued vertices; popped vertices have a new distance,
+// so the out-neighbours of each are touched
+static void propagate(DynSSSP *d) {
+   while (!pqIsEmpty(d->q)) {
+      Vertex u = pqLeave(d->q);
+      const DynArcList *l = &d->out[u];
+      for (int i = 0; i < l->n; i++) {
+         Vertex v = l->arcs[i].v;
+         int w = l->arcs[i].weight;
+         if (w <= 0)
+            continue;
+         touch(d, v);
+         long alt = (long)d->dist[u] + w;
+         if (alt < d->dist[v]) {
+            d->dist[v] = alt;
+            if (pqContains(d->q, v))
+               decreaseKey(d->q, v, alt);
+            else
+               pqJoin(d->q, v, alt);
+         }
+      }
+   }
+}
+
+// u -> v is new or cheaper, now weight w > 0
+static void lowered(DynSSSP *d, Vertex u, Vertex v, int w) {
+   touch(d, v);
+   long alt = (long)d->dist[u] + w;
+   if (d->dist[u] != DYN_NO_PATH && alt < d->dist[v]) {
+      d->dist[v] = alt;
+      pqJoin(d->q, v, alt);
+      propagate(d);
+   }
+}
+
+// does x keep a tight in-edge from an unaffected vertex?
+static bool supported(const DynSSSP *d, Vertex x) {
+   const DynArcList *l = &d->in[x];
+   for (int i = 0; i < l->n; i++) {
+      Vertex y = l->arcs[i].v;
+      if (!d->affected[y] && tight(d, y, x, l->arcs[i].weight))
+         return true;
+   }
+   return false;
+}
+
+// u -> v, of weight oldWeight > 0, is gone or dearer
+static void raised(DynSSSP *d, Vertex u, Vertex v, int oldWeight) {
+   touch(d, v);
+   if (!tight(d, u, v, oldWeight))
+      return;
+
+   // affected vertices, in order of distance: all their tight in-edges
+   // come from vertices decided before them
+   int nAffected = 0;
+   pqJoin(d->q, v, d->dist[v]);
+   while (!pqIsEmpty(d->q)) {
+      Vertex x = pqLeave(d->q);
+      if (supported(d, x))
+         continue;
+      d->affected[x] = true;
+      d->order[nAffected++] = x;
+      const DynArcList *l = &d->out[x];
+      for (int i = 0; i < l->n; i++) {
+         Vertex y = l->arcs[i].v;
+         if (!d->affected[y] && !pqContains(d->q, y) && tight(d, x, y, l->arcs[i].weight))
+            pqJoin(d->q, y, d->dist[y]);
+      }
+   }
+
+   for (int i = 0; i < nAffected; i++) {
+      touch(d, d->order[i]);
+      d->dist[d->order[i]] = DYN_NO_PATH;
+   }
+   // each restarts from its best in-edge out of the unaffected vertices;
+   // its out-neighbours may have lost it as their pred
+   for (int i = 0; i < nAffected; i++) {
+      Vertex x = d->order[i];
+      long best = DYN_NO_PATH;
+      const DynArcList *l = &d->in[x];
+      for (int j = 0; j < l->n; j++) {
+         Vertex y = l->arcs[j].v;
+         int w = l->arcs[j].weight;
+         if (w > 0 && !d->affected[y] && d->dist[y] != DYN_NO_PATH && d->dist[y] + (long)w < best)
+            best = d->dist[y] + (long)w;
+      }
+      if (best < DYN_NO_PATH) {
+         d->dist[x] = best;
+         pqJoin(d->q, x, best);
+      }
+      for (int j = 0; j < d->out[x].n; j++)
+         touch(d, d->out[x].arcs[j].v);
+   }
+   for (int i = 0; i < nAffected; i++)
+      d->affected[d->order[i]] = false;
+   propagate(d);
+}
+
+// u -> v went from weight before to after (0: absent or not positive)
+static int repair(DynSSSP *d, Vertex u, Vertex v, int before, int after) {
+   if (after > 0 && (before == 0 || after < before))
+      lowered(d, u, v, after);
+   else if (before > 0 && (after == 0 || after > before))
+      raised(d, u, v, before);
+   return settle(d);
+}
+
+/* ---------- interface ---------- */
+
+DynSSSP *newDynSSSP(Graph g, Vertex src) {
+   assert(g != NULL);
+   int nV = numOfVertices(g);
+   assert(src >= 0 && src < nV);
+
+   DynSSSP *d = malloc(sizeof(DynSSSP));
+   assert(d != NULL);
+   d->g = g;
+   d->nV = nV;
+   d->src = src;
+   d->dist = malloc(nV * sizeof(int));
+   d->pred = malloc(nV * sizeof(Vertex));
+   d->out = calloc(nV, sizeof(DynArcList));
+   d->in = calloc(nV, sizeof(DynArcList));
+   d->q = newPQueue(nV);
+   d->affected = calloc(nV, sizeof(bool));
+   d->order = malloc(nV * sizeof(Vertex));
+   d->seen = calloc(nV, sizeof(bool));
+   d->touched = malloc(nV * sizeof(Touched));
+   assert(d->dist != NULL && d->pred != NULL && d->out != NULL && d->in != NULL && d->affected != NULL
+          && d->order != NULL && d->seen != NULL && d->touched != NULL);
+   d->nTouched = 0;
+
+   for (Vertex u = 0; u < nV; u++) {
+      d->dist[u] = DYN_NO_PATH;
+      d->pred[u] = -1;
+      for (Vertex v = firstNeighbour(g, u); v != -1; v = nextNeighbour(g, u, v)) {
+         int w = edgeWeight(g, u, v);
+         addArc(&d->out[u], v, w);
+         addArc(&d->in[v], u, w);
+      }
+   }
+   d->dist[src] = 0;
+   pqJoin(d->q, src, 0);
+   propagate(d);
+   settle(d);
+   return d;
+}
+
+void freeDynSSSP(DynSSSP *d) {
+   if (d == NULL)
+      return;
+   for (Vertex v = 0; v < d->nV; v++) {
+      free(d->out[v].arcs);
+      free(d->in[v].arcs);
+   }
+   free(d->out);
+   free(d->in);
+   free(d->dist);
+   free(d->pred);
+   dropPQueue(d->q);
+   free(d->affected);
+   free(d->order);
+   free(d->seen);
+   free(d->touched);
+   free(d);
+}
+
+int dynSetEdge(DynSSSP *d, Edge e) {
+   assert(d != NULL && e.weight != NO_EDGE);
+
+   int i = findArc(&d->out[e.v], e.w);
+   int old = i >= 0 ? d->out[e.v].arcs[i].weight : NO_EDGE;
+   if (old == e.weight)
+      return 0;
+   if (old != NO_EDGE)
+      removeEdge(d->g, e);                 // insertEdge keeps an existing weight
+   insertEdge(d->g, e);
+   setArc(&d->out[e.v], e.w, e.weight);
+   setArc(&d->in[e.w], e.v, e.weight);
+   return repair(d, e.v, e.w, old > 0 ? old : 0, e.weight > 0 ? e.weight : 0);
+}
+
+int dynRemoveEdge(DynSSSP *d, Vertex v, Vertex w) {
+   assert(d != NULL);
+
+   int i = findArc(&d->out[v], w);
+   if (i < 0)
+      return 0;
+   int old = d->out[v].arcs[i].weight;
+   removeEdge(d->g, (Edge){ v, w, old });
+   dropArc(&d->out[v], w);
+   dropArc(&d->in[w], v);
+   return repair(d, v, w, old > 0 ? old : 0, 0);
+}
@@ -0,0 +1,69 @@
+// Single-source shortest paths kept up to date as the graph changes
+//
+// Seeded by one full Dijkstra run.  Afterwards every edge insertion,
+// deletion or weight change goes through dynSetEdge or dynRemoveEdge,
+// which change the graph and then repair dist and pred for the affected
+// vertices only (Ramalingam & Reps).  The results always equal those of
+// a fresh dijkstraSSSP run: edges with weight <= 0 are ignored, and
+// pred[v] is the lowest (dist[u], u) over the in-edges with
+// dist[u] + weight(u,v) == dist[v].
+//
+// The edges and their weights are copied into out- and in-lists, and the
+// repairs read only these, so each costs the same whichever WGraph
+// implementation holds the graph; the graph is still given every change.
+#ifndef DYNSSSP_H
+#define DYNSSSP_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include "WGraph.h"
+#include "PQueue.h"
+
+#define DYN_NO_PATH INT_MAX     // dist of an unreachable vertex
+
+typedef struct DynArc {
+   Vertex v;            // the other end
+   int    weight;       // as in the graph, <= 0 included
+} DynArc;
+
+typedef struct DynArcList {
+   DynArc *arcs;        // in any order
+   int     n;
+   int     cap;
+} DynArcList;
+
+typedef struct Touched {
+   Vertex v;
+   int    dist;         // before the change
+   Vertex pred;
+} Touched;
+
+typedef struct DynSSSP {
+   Graph       g;       // change it only through dynSetEdge/dynRemoveEdge
+   int         nV;
+   Vertex      src;
+   int        *dist;    // shortest distance from src, or DYN_NO_PATH
+   Vertex     *pred;    // previous vertex on it; -1 for src and unreachable
+   DynArcList *out;     // out-edges of every vertex
+   DynArcList *in;      // in-edges of every vertex, which WGraph cannot list
+   PQueue      q;
+   bool       *affected;// increase: every shortest path used the changed edge
+   Vertex     *order;   // the affected vertices, by distance before the change
+   bool       *seen;    // in touched
+   Touched    *touched; // vertices whose dist or pred may have changed
+   int         nTouched;
+} DynSSSP;
+
+// runs Dijkstra from src over g, which then belongs to the DynSSSP until
+// freeDynSSSP (which does not free it)
+DynSSSP *newDynSSSP(Graph g, Vertex src);
+void     freeDynSSSP(DynSSSP *);
+
+// insert e.v -> e.w, or change its weight, and repair; returns the number
+// of vertices whose dist or pred changed
+int dynSetEdge(DynSSSP *, Edge e);
+
+// remove v -> w if present, and repair; returns as dynSetEdge
+int dynRemoveEdge(DynSSSP *, Vertex v, Vertex w);
+
+#endif
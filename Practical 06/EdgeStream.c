@@ -0,0 +1,291 @@
+// Non-interactive edge input, streamed in blocks
+//
+// Text is cut into chunks at whitespace.  A first parallel pass counts the
+// integers in every chunk, which fixes where the input stops and so which
+// chunk holds which token; later passes parse the chunks in parallel and
+// pass on edges as they complete.  The few edges whose endpoints lie in two
+// chunks are collected on the side and passed on last.
+#define _POSIX_C_SOURCE 200809L
+#include "EdgeStream.h"
+#include "Parallel.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TEXT_CHUNK (1 << 20)     // bytes of text per parse step
+#define BLOCK 4096               // edges per call of the block function
+
+#define IS_SPACE(c) ((c) == ' ' || (c) == '\n' || (c) == '\t' || (c) == '\r' || (c) == '\v' || (c) == '\f')
+#define IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+
+typedef struct {
+   EdgeStream *s;
+   EdgeBlockFn body;
+   void       *arg;
+   Edge       *buf;              // BLOCK edges per thread
+   long       *edge;             // text: per chunk, the edge cut at its start, then its end
+   long       *count;            // first pass: #integers in each chunk
+   bool       *stopped;          // first pass: chunk hit a token that is not an integer
+   int         bad;              // set if any endpoint is out of range
+} Pass;
+
+// next integer in s..end-1: 1 found, 2 found but it runs into a non-space
+// (like scanf, the input stops after it), 0 none left, -1 not an integer
+static int nextToken(const char **s, const char *end, long *x) {
+   const char *p = *s;
+   while (p < end && IS_SPACE(*p))
+      p++;
+   if (p == end) {
+      *s = p;
+      return 0;
+   }
+   bool neg = *p == '-';
+   if (*p == '-' || *p == '+')
+      p++;
+   if (p == end || !IS_DIGIT(*p))
+      return -1;
+   long v = 0;
+   for (; p < end && IS_DIGIT(*p); p++)
+      if (v <= INT_MAX)                       // saturate; caught by range checks
+         v = 10 * v + (*p - '0');
+   *x = neg ? -v : v;
+   *s = p;
+   return p < end && !IS_SPACE(*p) ? 2 : 1;
+}
+
+static void countRange(int lo, int hi, int thread, void *arg) {
+   Pass *p = arg;
+   for (int c = lo; c < hi; c++) {
+      const char *s = p->s->text + p->s->cuts[c], *end = p->s->text + p->s->cuts[c + 1];
+      long x, n = 0;
+      int r;
+      while ((r = nextToken(&s, end, &x)) != 0) {
+         if (r > 0)
+            n++;
+         if (r != 1) {
+            p->stopped[c] = true;
+            break;
+         }
+      }
+      p->count[c] = n;
+   }
+}
+
+static void emit(Pass *p, int thread, long *n, long v, long w) {
+   Edge *buf = p->buf + (size_t)thread * BLOCK;
+   if (v < 0 || v >= p->s->nV || w < 0 || w >= p->s->nV) {
+      __atomic_store_n(&p->bad, 1, __ATOMIC_RELAXED);   // other threads may set it too
+      return;
+   }
+   buf[(*n)++] = (Edge){ v, w, 1 };
+   if (*n == BLOCK) {
+      p->body(buf, BLOCK, thread, p->arg);
+      *n = 0;
+   }
+}
+
+static void parseRange(int lo, int hi, int thread, void *arg) {
+   Pass *p = arg;
+   EdgeStream *s = p->s;
+   long n = 0;
+   for (int c = lo; c < hi; c++) {
+      const char *t = s->text + s->cuts[c], *end = s->text + s->cuts[c + 1];
+      long k = s->first[c], last = s->first[c + 1];   // global token indices
+      long x, v = -1;
+      // token 0 is the vertex count; token 2j+1 and 2j+2 make edge j
+      for (; k < last && nextToken(&t, end, &x) > 0; k++) {
+         if (k == 0)
+            continue;
+         if (k % 2 == 1) {
+            v = x;
+            if (k + 1 == last)                          // w is in a later chunk
+               p->edge[2 * c + 1] = x;
+         } else if (k == s->first[c]) {                 // v was in an earlier chunk
+            p->edge[2 * c] = x;
+         } else {
+            emit(p, thread, &n, v, x);
+         }
+      }
+   }
+   if (n > 0)
+      p->body(p->buf + (size_t)thread * BLOCK, n, thread, p->arg);
+}
+
+static void binaryRange(int lo, int hi, int thread, void *arg) {
+   Pass *p = arg;
+   const uint32_t *ends = (const uint32_t *)(p->s->text + sizeof(EdgeFileHeader));
+   long n = 0;
+   for (long i = (long)lo * BLOCK; i < (long)hi * BLOCK && i < p->s->nE; i++) {
+      uint32_t v = ends[2 * i], w = ends[2 * i + 1];
+      emit(p, thread, &n, v, w);
+   }
+   if (n > 0)
+      p->body(p->buf + (size_t)thread * BLOCK, n, thread, p->arg);
+}
+
+// cut the text at whitespace, count its integers and read the vertex count
+static bool scanText(EdgeStream *s) {
+   s->nChunks = s->len / TEXT_CHUNK + 1;
+   s->cuts = malloc((s->nChunks + 1) * sizeof(size_t));
+   s->first = malloc((s->nChunks + 1) * sizeof(long));
+   Pass p = { s, NULL, NULL, NULL, NULL, calloc(s->nChunks, sizeof(long)), calloc(s->nChunks, sizeof(bool)), 0 };
+   assert(s->cuts != NULL && s->first != NULL && p.count != NULL && p.stopped != NULL);
+   s->cuts[0] = 0;
+   for (int c = 1; c < s->nChunks; c++) {
+      size_t at = (size_t)c * TEXT_CHUNK;
+      if (at < s->cuts[c - 1])
+         at = s->cuts[c - 1];
+      while (at < s->len && !IS_SPACE(s->text[at]))
+         at++;
+      s->cuts[c] = at;
+   }
+   s->cuts[s->nChunks] = s->len;
+   parallelFor(s->nChunks, 1, s->nThreads, countRange, &p);
+
+   // tokens after the first one that is not an integer do not count
+   long total = 0;
+   bool stop = false;
+   for (int c = 0; c < s->nChunks; c++) {
+      s->first[c] = total;
+      if (!stop)
+         total += p.count[c];
+      stop = stop || p.stopped[c];
+   }
+   s->nE = total > 0 ? (total - 1) / 2 : 0;
+   total = total > 0 ? 1 + 2 * s->nE : 0;     // drop an unpaired last token
+   s->first[s->nChunks] = total;
+   for (int c = 0; c < s->nChunks; c++)
+      if (s->first[c] > total)
+         s->first[c] = total;
+   free(p.count);
+   free(p.stopped);
+
+   long nV = -1;
+   const char *t = s->text;
+   if (total > 0)
+      nextToken(&t, s->text + s->len, &nV);
+   if (nV < 1 || nV > INT_MAX) {
+      fprintf(stderr, "%s: invalid number of vertices.\n", s->name);
+      return false;
+   }
+   s->nV = nV;
+   return true;
+}
+
+static bool scanBinary(EdgeStream *s) {
+   EdgeFileHeader h;
+   memcpy(&h, s->text, sizeof h);
+   if (h.nV < 1 || h.nV > INT_MAX || h.nE > LONG_MAX / 8
+       || (s->len - sizeof h) / (2 * sizeof(uint32_t)) < h.nE) {
+      fprintf(stderr, "%s: bad edge file header.\n", s->name);
+      return false;
+   }
+   s->nV = h.nV;
+   s->nE = h.nE;
+   return true;
+}
+
+// all of stdin in one buffer
+static char *slurp(FILE *in, size_t *len) {
+   size_t cap = 1 << 16, n = 0, got;
+   char *buf = malloc(cap);
+   assert(buf != NULL);
+   while ((got = fread(buf + n, 1, cap - n, in)) > 0) {
+      n += got;
+      if (n == cap) {
+         cap *= 2;
+         buf = realloc(buf, cap);
+         assert(buf != NULL);
+      }
+   }
+   *len = n;
+   return buf;
+}
+
+bool openEdgeStream(const char *path, int nThreads, EdgeStream *s) {
+   assert(path != NULL && s != NULL);
+   memset(s, 0, sizeof *s);
+   s->nThreads = nThreads > 0 ? nThreads : defaultThreads();
+
+   if (strcmp(path, "-") == 0) {
+      s->name = "stdin";
+      s->text = slurp(stdin, &s->len);
+   } else {
+      s->name = path;
+      int fd = open(path, O_RDONLY);
+      struct stat st;
+      if (fd < 0 || fstat(fd, &st) != 0) {
+         perror(path);
+         if (fd >= 0)
+            close(fd);
+         return false;
+      }
+      s->len = st.st_size;
+      void *map = s->len > 0 ? mmap(NULL, s->len, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+      close(fd);
+      if (s->len > 0 && map == MAP_FAILED) {
+         perror(path);
+         return false;
+      }
+      s->text = map;
+      s->mapped = true;
+   }
+
+   s->binary = s->len >= sizeof(EdgeFileHeader) && memcmp(s->text, EDGE_FILE_MAGIC, 4) == 0;
+   bool ok = s->binary ? scanBinary(s) : scanText(s);
+   if (!ok)
+      closeEdgeStream(s);
+   return ok;
+}
+
+bool streamEdges(EdgeStream *s, EdgeBlockFn body, void *arg) {
+   assert(s != NULL && body != NULL);
+   Pass p = { s, body, arg, malloc((size_t)s->nThreads * BLOCK * sizeof(Edge)), NULL, NULL, NULL, 0 };
+   assert(p.buf != NULL);
+
+   if (s->binary) {
+      posix_madvise(s->text, s->len, POSIX_MADV_SEQUENTIAL);
+      parallelFor((s->nE + BLOCK - 1) / BLOCK, 1, s->nThreads, binaryRange, &p);
+   } else {
+      p.edge = malloc(2 * s->nChunks * sizeof(long));
+      assert(p.edge != NULL);
+      parallelFor(s->nChunks, 1, s->nThreads, parseRange, &p);
+
+      // pair the ends left over at chunk boundaries, in order
+      long n = 0, v = -1;
+      for (int c = 0; c < s->nChunks; c++) {
+         long k = s->first[c], last = s->first[c + 1];
+         if (k == last)
+            continue;
+         if (k > 0 && k % 2 == 0)                // chunk opens with a w
+            emit(&p, 0, &n, v, p.edge[2 * c]);
+         if (last > 1 && (last - 1) % 2 == 1)    // chunk closes with a v
+            v = p.edge[2 * c + 1];
+      }
+      if (n > 0)
+         body(p.buf, n, 0, arg);
+      free(p.edge);
+   }
+   free(p.buf);
+
+   if (p.bad)
+      fprintf(stderr, "%s: edge endpoint out of range.\n", s->name);
+   return !p.bad;
+}
+
+void closeEdgeStream(EdgeStream *s) {
+   assert(s != NULL);
+   if (s->mapped && s->len > 0)
+      munmap(s->text, s->len);
+   else if (!s->mapped)
+      free(s->text);
+   free(s->cuts);
+   free(s->first);
+   memset(s, 0, sizeof *s);
+}
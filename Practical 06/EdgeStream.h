@@ -0,0 +1,53 @@
+// Non-interactive edge input, streamed in blocks
+//
+// Files have the same shape as Practical 05 edge lists: binary files start
+// with an EdgeFileHeader followed by nE pairs of uint32 endpoints (v, w) in
+// host byte order; anything else is text holding the number of vertices and
+// then "v w" pairs, ending at end of file or at the first token that is not
+// an integer.  Edges are handed over in blocks, in parallel, with weight 1;
+// nothing the size of the edge list is kept in memory.
+#ifndef EDGESTREAM_H
+#define EDGESTREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "WGraph.h"
+
+#define EDGE_FILE_MAGIC "GEL1"
+
+typedef struct EdgeFileHeader {
+   char     magic[4];   // EDGE_FILE_MAGIC, no terminating '\0'
+   uint32_t nV;         // #vertices
+   uint64_t nE;         // #edge pairs that follow
+} EdgeFileHeader;
+
+typedef struct EdgeStream {
+   int     nV;          // #vertices
+   long    nE;          // #edges
+   int     nThreads;
+   char   *text;        // input, mapped or (stdin) read into memory
+   size_t  len;
+   bool    mapped;
+   bool    binary;
+   int     nChunks;     // text: pieces parsed in parallel
+   size_t *cuts;        // chunk c covers text[cuts[c] .. cuts[c+1]-1]
+   long   *first;       // index of the first token of each chunk
+   const char *name;
+} EdgeStream;
+
+// body(edges, n, thread, arg) gets edges[0..n-1]; calls on different
+// threads run at the same time
+typedef void (*EdgeBlockFn)(const Edge *edges, long n, int thread, void *arg);
+
+// open path ("-" reads text from stdin) and read its header or vertex count;
+// on failure reports on stderr, returns false
+bool openEdgeStream(const char *path, int nThreads, EdgeStream *);
+
+// hand every edge to body once; may be repeated.  On an endpoint out of
+// range reports on stderr and returns false (some blocks may have been seen)
+bool streamEdges(EdgeStream *, EdgeBlockFn body, void *arg);
+
+void closeEdgeStream(EdgeStream *);
+
+#endif
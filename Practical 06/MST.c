@@ -0,0 +1,385 @@
+// Minimum spanning forests over a WCSR view
+//
+// All three methods work on one list of undirected edges, ordered by
+// weight and then by position in the list, so every tie is broken the same
+// way.  Kruskal sorts that order and joins components with union-find.
+// Prim grows each tree from its lowest vertex with the indexed heap.
+// Boruvka works in rounds: every component picks its lightest outgoing
+// edge (threads race on compare-and-swap), the picked edges join the
+// components, pointer jumping relabels them, and edges inside a component
+// are dropped; O(log V) rounds, each parallel over the remaining edges.
+#include "MST.h"
+#include "PQueue.h"
+#include "Parallel.h"
+#include "Sort.h"
+#include "UnionFind.h"
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define EDGE_CHUNK 65536             // edges claimed at a time
+#define VERTEX_CHUNK 4096            // vertices claimed at a time
+
+typedef struct {
+   const WCSR *g;
+   int    nV;
+   int    nE;
+   Edge  *edges;                     // undirected, v < w
+   long  *first;                     // edges of row v start at first[v]
+   long  *adjAt;                     // Prim: ids[adjAt[v] .. adjAt[v+1]-1] are
+   int   *ids;                       // the edges at v
+   // Boruvka
+   int   *comp;                      // component (a vertex) of each vertex
+   int   *best;                      // lightest edge out of a component, -1 if none
+   int   *link;                      // component it joins
+   int   *active, *next;             // edges between components
+   long   nActive;
+   long  *kept;                      // per chunk: #active edges kept
+   int   *tree;
+   int    nTree;
+   bool   changed;
+} Mst;
+
+// edge a is lighter than edge b (b may be -1: none)
+static bool lighter(const Mst *m, int a, int b) {
+   return b < 0 || m->edges[a].weight < m->edges[b].weight
+          || (m->edges[a].weight == m->edges[b].weight && a < b);
+}
+
+/* ---------- undirected edge list ---------- */
+
+// arc e of row v stands for its pair: no reverse arc, a heavier one, or an
+// equal one from a higher vertex
+static bool counts(const WCSR *g, Vertex v, long e) {
+   Vertex w = g->targets[e];
+   if (w == v)
+      return false;
+   long lo = g->offsets[w], hi = g->offsets[w + 1];
+   while (lo < hi) {                                // targets ascend in a row
+      long mid = lo + (hi - lo) / 2;
+      if (g->targets[mid] < v)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   if (lo == g->offsets[w + 1] || g->targets[lo] != v)
+      return true;
+   return g->weights[e] < g->weights[lo] || (g->weights[e] == g->weights[lo] && v < w);
+}
+
+static void countRows(int lo, int hi, int thread, void *arg) {
+   Mst *m = arg;
+   for (Vertex v = lo; v < hi; v++) {
+      long n = 0;
+      for (long e = m->g->offsets[v]; e < m->g->offsets[v + 1]; e++)
+         n += counts(m->g, v, e);
+      m->first[v + 1] = n;
+   }
+}
+
+static void fillRows(int lo, int hi, int thread, void *arg) {
+   Mst *m = arg;
+   for (Vertex v = lo; v < hi; v++) {
+      long i = m->first[v];
+      for (long e = m->g->offsets[v]; e < m->g->offsets[v + 1]; e++) {
+         if (!counts(m->g, v, e))
+            continue;
+         Vertex w = m->g->targets[e];
+         m->edges[i++] = (Edge){ v < w ? v : w, v < w ? w : v, m->g->weights[e] };
+      }
+   }
+}
+
+static void buildEdges(Mst *m, int nThreads) {
+   m->first = malloc((m->nV + 1) * sizeof(long));
+   assert(m->first != NULL);
+   m->first[0] = 0;
+   parallelFor(m->nV, VERTEX_CHUNK, nThreads, countRows, m);
+   for (Vertex v = 0; v < m->nV; v++)
+      m->first[v + 1] += m->first[v];
+   assert(m->first[m->nV] <= INT_MAX);
+   m->nE = m->first[m->nV];
+   m->edges = malloc((m->nE > 0 ? m->nE : 1) * sizeof(Edge));
+   assert(m->edges != NULL);
+   parallelFor(m->nV, VERTEX_CHUNK, nThreads, fillRows, m);
+}
+
+/* ---------- Kruskal ---------- */
+
+static void kruskal(Mst *m, int nThreads) {
+   KeyIndex *order = malloc((m->nE > 0 ? m->nE : 1) * sizeof(KeyIndex));
+   assert(order != NULL);
+   for (int e = 0; e < m->nE; e++) {
+      order[e].key = (uint32_t)m->edges[e].weight ^ 0x80000000u;
+      order[e].index = e;
+   }
+   sortKeyIndex(order, m->nE, nThreads);
+
+   UnionFind uf = newUnionFind(m->nV);
+   for (int i = 0; i < m->nE && m->nTree < m->nV - 1; i++) {
+      int e = order[i].index;
+      if (ufUnion(uf, m->edges[e].v, m->edges[e].w))
+         m->tree[m->nTree++] = e;
+   }
+   freeUnionFind(uf);
+   free(order);
+}
+
+/* ---------- Prim ---------- */
+
+static void prim(Mst *m) {
+   int nV = m->nV;
+   m->adjAt = calloc(nV + 1, sizeof(long));
+   m->ids = malloc((2L * m->nE > 0 ? 2L * m->nE : 1) * sizeof(int));
+   int *bestEdge = malloc(nV * sizeof(int));
+   bool *done = calloc(nV, sizeof(bool));
+   assert(m->adjAt != NULL && m->ids != NULL && bestEdge != NULL && done != NULL);
+   for (int e = 0; e < m->nE; e++) {
+      m->adjAt[m->edges[e].v + 1]++;
+      m->adjAt[m->edges[e].w + 1]++;
+   }
+   for (Vertex v = 0; v < nV; v++)
+      m->adjAt[v + 1] += m->adjAt[v];
+   long *at = malloc((nV > 0 ? nV : 1) * sizeof(long));
+   assert(at != NULL);
+   for (Vertex v = 0; v < nV; v++) {
+      at[v] = m->adjAt[v];
+      bestEdge[v] = -1;
+   }
+   for (int e = 0; e < m->nE; e++) {
+      m->ids[at[m->edges[e].v]++] = e;
+      m->ids[at[m->edges[e].w]++] = e;
+   }
+   free(at);
+
+   PQueue q = newPQueue(nV);
+   for (Vertex root = 0; root < nV; root++) {
+      if (done[root])
+         continue;
+      pqJoin(q, root, 0);
+      while (!pqIsEmpty(q)) {
+         Vertex u = pqLeave(q);
+         done[u] = true;
+         if (bestEdge[u] >= 0)
+            m->tree[m->nTree++] = bestEdge[u];
+         for (long i = m->adjAt[u]; i < m->adjAt[u + 1]; i++) {
+            int e = m->ids[i];
+            Vertex x = m->edges[e].v ^ m->edges[e].w ^ u;
+            if (done[x] || !lighter(m, e, bestEdge[x]))
+               continue;
+            int weight = m->edges[e].weight;
+            if (!pqContains(q, x))
+               pqJoin(q, x, weight);
+            else if (weight < m->edges[bestEdge[x]].weight)
+               decreaseKey(q, x, weight);
+            bestEdge[x] = e;
+         }
+      }
+   }
+   dropPQueue(q);
+   free(done);
+   free(bestEdge);
+}
+
+/* ---------- Boruvka ---------- */
+
+static void offer(Mst *m, int c, int e) {
+   int cur = __atomic_load_n(&m->best[c], __ATOMIC_RELAXED);
+   while (lighter(m, e, cur))
+      if (__atomic_compare_exchange_n(&m->best[c], &cur, e, false,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+         break;
+}
+
+// each component's lightest outgoing edge; count the edges still between components
+static void pickEdges(int lo, int hi, int thread, void *arg) {
+   Mst *m = arg;
+   long n = 0;
+   for (int i = lo; i < hi; i++) {
+      int e = m->active[i];
+      int cv = m->comp[m->edges[e].v], cw = m->comp[m->edges[e].w];
+      if (cv == cw)
+         continue;
+      offer(m, cv, e);
+      offer(m, cw, e);
+      n++;
+   }
+   m->kept[lo / EDGE_CHUNK] = n;
+}
+
+// kept[] holds each chunk's first output position by now
+static void keepEdges(int lo, int hi, int thread, void *arg) {
+   Mst *m = arg;
+   long at = m->kept[lo / EDGE_CHUNK];
+   for (int i = lo; i < hi; i++) {
+      int e = m->active[i];
+      if (m->comp[m->edges[e].v] != m->comp[m->edges[e].w])
+         m->next[at++] = e;
+   }
+}
+
+static void linkComponents(int lo, int hi, int thread, void *arg) {
+   Mst *m = arg;
+   for (Vertex c = lo; c < hi; c++) {
+      int e = m->best[c];
+      if (m->comp[c] != c || e < 0)
+         continue;
+      Vertex other = m->comp[m->edges[e].v] ^ m->comp[m->edges[e].w] ^ c;
+      m->link[c] = other;
+   }
+}
+
+// Two components that picked each other share one edge: the lower one
+// stays a root.  Every other link adds its edge to the tree.  (Only a
+// component's own link is read or written here.)
+static void addEdges(int lo, int hi, int thread, void *arg) {
+   Mst *m = arg;
+   for (Vertex c = lo; c < hi; c++) {
+      if (m->comp[c] != c || m->best[c] < 0)
+         continue;
+      Vertex other = m->link[c];
+      if (m->best[other] == m->best[c] && c < other) {
+         m->link[c] = c;
+         continue;
+      }
+      int at = __atomic_fetch_add(&m->nTree, 1, __ATOMIC_RELAXED);
+      m->tree[at] = m->best[c];
+   }
+}
+
+// link[c] = link[link[c]] until links point at roots; racing updates
+// only ever skip further up the same chain
+static void jump(int lo, int hi, int thread, void *arg) {
+   Mst *m = arg;
+   bool changed = false;
+   for (Vertex c = lo; c < hi; c++) {
+      int l = __atomic_load_n(&m->link[c], __ATOMIC_RELAXED);
+      int ll = __atomic_load_n(&m->link[l], __ATOMIC_RELAXED);
+      if (ll != l) {
+         __atomic_store_n(&m->link[c], ll, __ATOMIC_RELAXED);
+         changed = true;
+      }
+   }
+   if (changed)
+      __atomic_store_n(&m->changed, true, __ATOMIC_RELAXED);
+}
+
+static void relabel(int lo, int hi, int thread, void *arg) {
+   Mst *m = arg;
+   for (Vertex v = lo; v < hi; v++)
+      m->comp[v] = m->link[m->comp[v]];
+}
+
+static void resetLinks(int lo, int hi, int thread, void *arg) {
+   Mst *m = arg;
+   for (Vertex v = lo; v < hi; v++) {
+      m->link[v] = v;
+      m->best[v] = -1;
+   }
+}
+
+static void boruvka(Mst *m, int nThreads) {
+   int nV = m->nV;
+   m->comp = malloc((nV > 0 ? nV : 1) * sizeof(int));
+   m->best = malloc((nV > 0 ? nV : 1) * sizeof(int));
+   m->link = malloc((nV > 0 ? nV : 1) * sizeof(int));
+   m->active = malloc((m->nE > 0 ? m->nE : 1) * sizeof(int));
+   m->next = malloc((m->nE > 0 ? m->nE : 1) * sizeof(int));
+   m->kept = malloc((m->nE / EDGE_CHUNK + 2) * sizeof(long));
+   assert(m->comp != NULL && m->best != NULL && m->link != NULL
+          && m->active != NULL && m->next != NULL && m->kept != NULL);
+   for (Vertex v = 0; v < nV; v++) {
+      m->comp[v] = m->link[v] = v;
+      m->best[v] = -1;
+   }
+   for (int e = 0; e < m->nE; e++)
+      m->active[e] = e;
+   m->nActive = m->nE;
+
+   while (m->nActive > 0) {
+      int nChunks = (m->nActive + EDGE_CHUNK - 1) / EDGE_CHUNK;
+      parallelFor(m->nActive, EDGE_CHUNK, nThreads, pickEdges, m);
+      long nKept = 0;
+      for (int c = 0; c < nChunks; c++) {
+         long n = m->kept[c];
+         m->kept[c] = nKept;
+         nKept += n;
+      }
+      if (nKept == 0)
+         break;
+      parallelFor(m->nActive, EDGE_CHUNK, nThreads, keepEdges, m);
+      int *t = m->active;
+      m->active = m->next;
+      m->next = t;
+      m->nActive = nKept;
+
+      parallelFor(nV, VERTEX_CHUNK, nThreads, linkComponents, m);
+      parallelFor(nV, VERTEX_CHUNK, nThreads, addEdges, m);
+      do {
+         m->changed = false;
+         parallelFor(nV, VERTEX_CHUNK, nThreads, jump, m);
+      } while (m->changed);
+      parallelFor(nV, VERTEX_CHUNK, nThreads, relabel, m);
+      parallelFor(nV, VERTEX_CHUNK, nThreads, resetLinks, m);
+   }
+   free(m->comp);
+   free(m->best);
+   free(m->link);
+   free(m->active);
+   free(m->next);
+   free(m->kept);
+}
+
+/* ---------- interface ---------- */
+
+static int byEnds(const void *a, const void *b, void *ctx) {
+   const Edge *x = a, *y = b;
+   if (x->v != y->v)
+      return x->v < y->v ? -1 : 1;
+   return (x->w > y->w) - (x->w < y->w);
+}
+
+MstMethod spanningForest(WCSR *g, MstMethod method, int nThreads, Edge *tree, int *nTree, long *total) {
+   assert(g != NULL && tree != NULL && nTree != NULL && total != NULL);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+
+   Mst m = { .g = g, .nV = g->nV };
+   buildEdges(&m, nThreads);
+   m.tree = malloc((m.nV > 0 ? m.nV : 1) * sizeof(int));
+   assert(m.tree != NULL);
+
+   // Prim costs about E log V on one thread, Kruskal a sort of E edges;
+   // Boruvka only pays off with threads to spare
+   if (method == MST_AUTO) {
+      if (nThreads > 1 && m.nE >= EDGE_CHUNK)
+         method = MST_BORUVKA;
+      else if (m.nE > 2.0 * m.nV * log2(m.nV + 1.0))
+         method = MST_PRIM;
+      else
+         method = MST_KRUSKAL;
+   }
+   if (method == MST_KRUSKAL)
+      kruskal(&m, nThreads);
+   else if (method == MST_PRIM)
+      prim(&m);
+   else
+      boruvka(&m, nThreads);
+
+   *total = 0;
+   for (int i = 0; i < m.nTree; i++) {
+      tree[i] = m.edges[m.tree[i]];
+      *total += tree[i].weight;
+   }
+   *nTree = m.nTree;
+   sortGeneric(tree, m.nTree, sizeof(Edge), byEnds, NULL);
+
+   free(m.tree);
+   free(m.edges);
+   free(m.first);
+   free(m.adjAt);
+   free(m.ids);
+   return method;
+}
@@ -0,0 +1,20 @@
+// Minimum spanning forests over a WCSR view
+//
+// Arcs are read as undirected edges: a pair joined in both directions is
+// one edge, with the lower of the two weights.  Self-loops are ignored.
+#ifndef MST_H
+#define MST_H
+
+#include "WCSR.h"
+
+typedef enum { MST_AUTO, MST_KRUSKAL, MST_PRIM, MST_BORUVKA } MstMethod;
+
+// Minimum spanning forest: its edges go to tree[0..*nTree-1] (room for
+// nV-1 is enough), each with v < w, ordered by (v, w); *total = sum of
+// their weights.  Weight ties go to the edge found first, so Kruskal and
+// Boruvka give the same forest; Prim may take other edges of the same
+// weight, with the same total.  MST_AUTO picks a method from the density
+// and the number of threads; returns the method used
+MstMethod spanningForest(WCSR *, MstMethod, int nThreads, Edge *tree, int *nTree, long *total);
+
+#endif
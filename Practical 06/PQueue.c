@@ -1,32 +1,146 @@
-// Priority Queue ADO implementation ... COMP9024 25T1
+// Priority Queue ADT implementation ... COMP9024 25T1
+// Indexed binary heap: join, leave and decreaseKey in O(log n)
 
 #include "PQueue.h"
 #include <assert.h>
+#include <stdlib.h>
 
-#define VERY_HIGH_VALUE 999999
+typedef struct PQueueRep {
+   Vertex *heap;     // heap[0..length-1], heap[0] leaves next
+   int    *pos;      // pos[v] = index of v in heap[], -1 if not queued
+   int    *key;      // key[v] = priority of queued vertex v
+   int     length;   // #vertices currently queued
+   int     nV;       // vertices are 0..nV-1
+} PQueueRep;
 
-typedef struct {
-   Vertex item[MAX_NODES];  // array of vertices currently in queue
-   int    length;           // #values currently stored in item[] array
-} PQueueT;
+// does vertex a leave before vertex b?
+static bool before(PQueue q, Vertex a, Vertex b) {
+   return q->key[a] < q->key[b] || (q->key[a] == q->key[b] && a < b);
+}
+
+static void place(PQueue q, int i, Vertex v) {
+   q->heap[i] = v;
+   q->pos[v] = i;
+}
+
+static void siftUp(PQueue q, int i) {
+   Vertex v = q->heap[i];
+   while (i > 0 && before(q, v, q->heap[(i - 1) / 2])) {
+      place(q, i, q->heap[(i - 1) / 2]);
+      i = (i - 1) / 2;
+   }
+   place(q, i, v);
+}
+
+static void siftDown(PQueue q, int i) {
+   Vertex v = q->heap[i];
+   for (;;) {
+      int c = 2 * i + 1;
+      if (c >= q->length)
+         break;
+      if (c + 1 < q->length && before(q, q->heap[c + 1], q->heap[c]))
+         c++;
+      if (!before(q, q->heap[c], v))
+         break;
+      place(q, i, q->heap[c]);
+      i = c;
+   }
+   place(q, i, v);
+}
 
-static PQueueT PQueue;      // defines the Priority Queue Object
+PQueue newPQueue(int nV) {
+   assert(nV >= 0);
+
+   PQueue q = malloc(sizeof(PQueueRep));
+   assert(q != NULL);
+   q->heap = malloc((nV > 0 ? nV : 1) * sizeof(Vertex));
+   q->pos = malloc((nV > 0 ? nV : 1) * sizeof(int));
+   q->key = malloc((nV > 0 ? nV : 1) * sizeof(int));
+   assert(q->heap != NULL && q->pos != NULL && q->key != NULL);
+   for (int v = 0; v < nV; v++)
+      q->pos[v] = -1;
+   q->length = 0;
+   q->nV = nV;
+   return q;
+}
+
+void dropPQueue(PQueue q) {
+   assert(q != NULL);
+
+   free(q->heap);
+   free(q->pos);
+   free(q->key);
+   free(q);
+}
+
+// insert vertex v with the given priority; v must not be queued
+void pqJoin(PQueue q, Vertex v, int priority) {
+   assert(q != NULL && v >= 0 && v < q->nV && q->pos[v] == -1);
+
+   q->key[v] = priority;
+   place(q, q->length, v);
+   q->length++;
+   siftUp(q, q->length - 1);
+}
+
+// lower the priority of queued vertex v
+void decreaseKey(PQueue q, Vertex v, int priority) {
+   assert(q != NULL && v >= 0 && v < q->nV && q->pos[v] != -1 && priority <= q->key[v]);
+
+   q->key[v] = priority;
+   siftUp(q, q->pos[v]);
+}
+
+// remove the highest priority vertex (lowest priority value)
+Vertex pqLeave(PQueue q) {
+   assert(q != NULL && q->length > 0);
+
+   Vertex v = q->heap[0];
+   q->pos[v] = -1;
+   q->length--;
+   if (q->length > 0) {
+      place(q, 0, q->heap[q->length]);      // replace root by last element
+      siftDown(q, 0);
+   }
+   return v;
+}
+
+bool pqContains(PQueue q, Vertex v) {
+   assert(q != NULL && v >= 0 && v < q->nV);
+
+   return q->pos[v] != -1;
+}
+
+bool pqIsEmpty(PQueue q) {
+   assert(q != NULL);
+
+   return q->length == 0;
+}
+
+/* ---------- shared queue ---------- */
+
+static PQueue Shared;                 // the queue behind the functions below
+static Vertex Joined[MAX_NODES];      // vertices joined since the last leave
+static bool   IsJoined[MAX_NODES];
+static int    nJoined;
 
 // set up empty priority queue
 void PQueueInit() {
-   PQueue.length = 0;
+   if (Shared != NULL)
+      dropPQueue(Shared);
+   Shared = newPQueue(MAX_NODES);
+   for (int i = 0; i < nJoined; i++)
+      IsJoined[Joined[i]] = false;
+   nJoined = 0;
 }
 
 // insert vertex v into priority queue
-// no effect if v is already in the queue
-void joinPQueue(int v) {
-   assert(PQueue.length < MAX_NODES);                // ensure queue ADO is not full
-   int i = 0;
-   while (i < PQueue.length && PQueue.item[i] != v)  // check if v already in queue
-      i++;
-   if (i == PQueue.length) {                         // v not found => add it at the end
-      PQueue.item[PQueue.length] = v;
-      PQueue.length++;
+// its priority is read from the array passed to the next leavePQueue
+void joinPQueue(Vertex v) {
+   assert(Shared != NULL && v >= 0 && v < MAX_NODES);
+   if (!IsJoined[v]) {
+      IsJoined[v] = true;
+      Joined[nJoined++] = v;
    }
 }
 
@@ -34,23 +148,25 @@ void joinPQueue(int v) {
 // highest priority = lowest value priority[v]
 // returns the removed vertex
 Vertex leavePQueue(int priority[]) {
-   assert(PQueue.length > 0);
-
-   int i, bestIndex = 0, bestVertex = PQueue.item[0], bestWeight = VERY_HIGH_VALUE;
-   for (i = 0; i < PQueue.length; i++) {         // find i with min priority[item[i]]
-      if (priority[PQueue.item[i]] < bestWeight) {
-         bestIndex = i;
-         bestWeight = priority[PQueue.item[i]];
-	 bestVertex = PQueue.item[i];            // vertex with lowest value so far
+   assert(Shared != NULL);
+
+   // bring the vertices joined since the last leave up to date
+   for (int i = 0; i < nJoined; i++) {
+      Vertex v = Joined[i];
+      IsJoined[v] = false;
+      if (!pqContains(Shared, v)) {
+         pqJoin(Shared, v, priority[v]);
+      } else {
+         Shared->key[v] = priority[v];
+         siftUp(Shared, Shared->pos[v]);
+         siftDown(Shared, Shared->pos[v]);
       }
    }
-   PQueue.length--;
-   PQueue.item[bestIndex] = PQueue.item[PQueue.length];  // replace dequeued node
-							 // by last element in array
-   return bestVertex;
+   nJoined = 0;
+   return pqLeave(Shared);
 }
 
 // check if priority queue PQueue is empty
 bool PQueueIsEmpty() {
-   return (PQueue.length == 0);
-}
\ No newline at end of file
+   return Shared == NULL || (pqIsEmpty(Shared) && nJoined == 0);
+}
\ No newline at end of file
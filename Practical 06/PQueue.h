@@ -1,11 +1,29 @@
-// Priority Queue ADO header ... COMP9024 25T1
+// Priority Queue ADT header ... COMP9024 25T1
+#ifndef PQUEUE_H
+#define PQUEUE_H
 
 #include "WGraph.h"
 #include <stdbool.h>
 
 #define MAX_NODES 1000
 
+// indexed binary min-heap over vertices 0..n-1
+// lowest priority leaves first, ties go to the lower vertex
+typedef struct PQueueRep *PQueue;
+
+PQueue newPQueue(int);                  // empty queue for vertices 0..n-1
+void   dropPQueue(PQueue);
+void   pqJoin(PQueue, Vertex, int);     // add v (not queued) with a priority
+void   decreaseKey(PQueue, Vertex, int);// lower the priority of queued v
+Vertex pqLeave(PQueue);                 // remove and return the first vertex
+bool   pqContains(PQueue, Vertex);
+bool   pqIsEmpty(PQueue);
+
+// single shared queue of up to MAX_NODES vertices, priorities read at leave time;
+// (re)join a vertex after changing its priority
 void   PQueueInit();
 void   joinPQueue(Vertex);
 Vertex leavePQueue(int[]);
-bool   PQueueIsEmpty();
\ No newline at end of file
+bool   PQueueIsEmpty();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,171 @@
+// PageRank over the links of an edge stream
+//
+// Links are kept by target, so a step computes each new rank from the
+// ranks of its sources alone: threads write disjoint parts of the new
+// vector and need no atomics.  Sums that cover all vertices (the dangling
+// rank and the residual) are taken per fixed chunk and added up in chunk
+// order, so results do not depend on the number of threads or on which
+// thread ran which chunk.
+#include "PageRank.h"
+#include "Parallel.h"
+#include "Sort.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RANK_CHUNK 4096          // vertices per parallel step
+
+/* ---------- building the in-links ---------- */
+
+typedef struct {
+   InLinks *g;
+   long    *next;                // first free slot of each row
+} Build;
+
+static void countLinks(const Edge *edges, long n, int thread, void *arg) {
+   Build *b = arg;
+   for (long i = 0; i < n; i++) {
+      __atomic_fetch_add(&b->g->outDegree[edges[i].v], 1, __ATOMIC_RELAXED);
+      __atomic_fetch_add(&b->next[edges[i].w], 1, __ATOMIC_RELAXED);
+   }
+}
+
+static void placeLinks(const Edge *edges, long n, int thread, void *arg) {
+   Build *b = arg;
+   for (long i = 0; i < n; i++) {
+      long at = __atomic_fetch_add(&b->next[edges[i].w], 1, __ATOMIC_RELAXED);
+      b->g->sources[at] = edges[i].v;
+   }
+}
+
+// rows were filled in whatever order the threads got there
+static void sortRows(int lo, int hi, int thread, void *arg) {
+   InLinks *g = arg;
+   for (Vertex v = lo; v < hi; v++)
+      pdqSortInts(g->sources + g->offsets[v], g->offsets[v + 1] - g->offsets[v]);
+}
+
+InLinks *newInLinks(EdgeStream *s) {
+   InLinks *g = malloc(sizeof(InLinks));
+   assert(g != NULL);
+   g->nV = s->nV;
+   g->offsets = malloc((g->nV + 1L) * sizeof(long));
+   g->outDegree = calloc(g->nV, sizeof(int));
+   g->sources = NULL;
+   Build b = {g, calloc(g->nV, sizeof(long))};
+   assert(g->offsets != NULL && g->outDegree != NULL && b.next != NULL);
+
+   bool ok = streamEdges(s, countLinks, &b);
+   if (ok) {
+      long at = 0;
+      for (Vertex v = 0; v < g->nV; v++) {
+         g->offsets[v] = at;
+         at += b.next[v];
+         b.next[v] = g->offsets[v];
+      }
+      g->offsets[g->nV] = g->nE = at;
+      g->sources = malloc((at > 0 ? at : 1) * sizeof(Vertex));
+      assert(g->sources != NULL);
+      ok = streamEdges(s, placeLinks, &b);
+   }
+   free(b.next);
+   if (!ok) {
+      freeInLinks(g);
+      return NULL;
+   }
+   parallelFor(g->nV, RANK_CHUNK, s->nThreads, sortRows, g);
+   return g;
+}
+
+void freeInLinks(InLinks *g) {
+   if (g == NULL)
+      return;
+   free(g->offsets);
+   free(g->sources);
+   free(g->outDegree);
+   free(g);
+}
+
+/* ---------- power iteration ---------- */
+
+typedef struct {
+   const InLinks *g;
+   double  damping;
+   double  base;                 // rank every vertex gets before its links
+   double *rank;
+   double *next;
+   double *share;                // rank[u] / outDegree[u]
+   double *partial;              // per chunk: dangling rank, then residual
+} Step;
+
+static void shareRange(int lo, int hi, int thread, void *arg) {
+   Step *s = arg;
+   double dangling = 0;
+   for (Vertex u = lo; u < hi; u++) {
+      int d = s->g->outDegree[u];
+      if (d == 0)
+         dangling += s->rank[u];
+      s->share[u] = d > 0 ? s->rank[u] / d : 0;
+   }
+   s->partial[lo / RANK_CHUNK] = dangling;
+}
+
+static void pullRange(int lo, int hi, int thread, void *arg) {
+   Step *s = arg;
+   const InLinks *g = s->g;
+   double change = 0;
+   for (Vertex v = lo; v < hi; v++) {
+      double sum = 0;
+      for (long e = g->offsets[v]; e < g->offsets[v + 1]; e++)
+         sum += s->share[g->sources[e]];
+      double r = s->base + s->damping * sum;
+      change += fabs(r - s->rank[v]);
+      s->next[v] = r;
+   }
+   s->partial[lo / RANK_CHUNK] = change;
+}
+
+static double total(const double *partial, int n) {
+   double sum = 0;
+   for (int i = 0; i < n; i++)
+      sum += partial[i];
+   return sum;
+}
+
+int pageRank(const InLinks *g, double damping, double tolerance, int maxIter,
+             int nThreads, double *rank, double *residual, FILE *trace) {
+   assert(damping >= 0 && damping < 1);
+   int nV = g->nV, nChunks = (nV + RANK_CHUNK - 1) / RANK_CHUNK;
+   Step s = {g, damping, 0, rank, malloc(nV * sizeof(double)),
+             malloc(nV * sizeof(double)), malloc((nChunks + 1) * sizeof(double))};
+   assert(s.next != NULL && s.share != NULL && s.partial != NULL);
+   for (Vertex v = 0; v < nV; v++)
+      rank[v] = 1.0 / nV;
+
+   double change = INFINITY;
+   int iter = 0;
+   while (iter < maxIter && !(change < tolerance)) {
+      parallelFor(nV, RANK_CHUNK, nThreads, shareRange, &s);
+      double dangling = total(s.partial, nChunks);
+      s.base = ((1 - damping) + damping * dangling) / nV;
+      parallelFor(nV, RANK_CHUNK, nThreads, pullRange, &s);
+      change = total(s.partial, nChunks);
+      double *t = s.rank;
+      s.rank = s.next;
+      s.next = t;
+      iter++;
+      if (trace != NULL)
+         fprintf(trace, "iteration %d: residual %.3e\n", iter, change);
+   }
+   if (s.rank != rank) {                       // odd #steps: last one is in next
+      memcpy(rank, s.rank, nV * sizeof(double));
+      s.next = s.rank;
+   }
+   if (residual != NULL)
+      *residual = change;
+   free(s.next);
+   free(s.share);
+   free(s.partial);
+   return iter;
+}
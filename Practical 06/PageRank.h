@@ -0,0 +1,29 @@
+// PageRank over the links of an edge stream
+#ifndef PAGERANK_H
+#define PAGERANK_H
+
+#include <stdio.h>
+#include "EdgeStream.h"
+
+typedef struct InLinks {
+   int     nV;          // #vertices
+   long    nE;          // #links (repeated edges count every time)
+   long   *offsets;     // links into v: sources[offsets[v] .. offsets[v+1]-1]
+   Vertex *sources;     // ascending within each row
+   int    *outDegree;   // #links out of v
+} InLinks;
+
+// two passes over the stream: count, then place; NULL (with a message on
+// stderr from the stream) if an endpoint is out of range
+InLinks *newInLinks(EdgeStream *);
+void     freeInLinks(InLinks *);
+
+// Power iteration, pulling along in-links, until the L1 change of the rank
+// vector drops below tolerance or maxIter steps have run.  rank[v] sums to
+// 1; dangling vertices (no out-links) spread their rank over all vertices.
+// The residual after every step goes to trace unless it is NULL; the final
+// one to *residual unless that is NULL.  Returns #iterations run.
+int pageRank(const InLinks *, double damping, double tolerance, int maxIter,
+             int nThreads, double *rank, double *residual, FILE *trace);
+
+#endif
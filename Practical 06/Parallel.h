@@ -0,0 +1,12 @@
+// Parallel loop helper on POSIX threads
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+// body(lo, hi, thread, arg) handles indices lo..hi-1 on worker number thread
+typedef void (*RangeFn)(int lo, int hi, int thread, void *arg);
+
+int  defaultThreads(void);                         // #online CPUs (at least 1)
+void parallelFor(int n, int chunk, int nThreads,   // run body over 0..n-1 in
+                 RangeFn body, void *arg);         // chunks, claimed dynamically
+
+#endif
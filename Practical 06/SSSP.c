@@ -0,0 +1,202 @@
+// Single-source shortest paths over a WCSR view
+//
+// Delta-stepping (Meyer & Sanders): vertices wait in buckets of width delta
+// by tentative distance.  The lowest non-empty bucket is emptied by relaxing
+// the light edges (weight <= delta) of its vertices in parallel, over and over
+// until no vertex falls back into it, and then the heavy edges of everything
+// it held are relaxed once.  Distances are lowered with compare-and-swap, so
+// they come out exact whatever the interleaving; predecessors are then fixed
+// in a separate pass so that they do not depend on it either.
+#include "SSSP.h"
+#include "Parallel.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define UNREACHED LONG_MAX
+#define RELAX_CHUNK 64              // frontier vertices claimed at a time
+#define CACHE_LINE 64
+
+typedef struct {
+   Vertex *v;
+   long    n;
+   long    cap;
+} VList;
+
+// per-thread list of vertices whose distance dropped, padded to a cache line
+typedef union {
+   VList list;
+   char  pad[CACHE_LINE];
+} Improved;
+
+typedef struct {
+   const WCSR   *g;
+   long          delta;
+   long         *dist;
+   const Vertex *frontier;
+   bool          heavy;             // relax heavy (true) or light (false) edges
+   Improved     *out;               // per thread
+   Vertex       *pred;
+} Step;
+
+static void push(VList *l, Vertex v) {
+   if (l->n == l->cap) {
+      l->cap = l->cap > 0 ? 2 * l->cap : 64;
+      l->v = realloc(l->v, l->cap * sizeof(Vertex));
+      assert(l->v != NULL);
+   }
+   l->v[l->n++] = v;
+}
+
+static void relax(int lo, int hi, int thread, void *arg) {
+   Step *s = arg;
+   const WCSR *g = s->g;
+   for (int i = lo; i < hi; i++) {
+      Vertex u = s->frontier[i];
+      long du = __atomic_load_n(&s->dist[u], __ATOMIC_RELAXED);
+      for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+         int w = g->weights[e];
+         if (w <= 0 || (w > s->delta) != s->heavy)
+            continue;
+         Vertex v = g->targets[e];
+         long nd = du + w;
+         long old = __atomic_load_n(&s->dist[v], __ATOMIC_RELAXED);
+         while (nd < old) {
+            if (__atomic_compare_exchange_n(&s->dist[v], &old, nd, false,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+               push(&s->out[thread].list, v);
+               break;
+            }
+         }
+      }
+   }
+}
+
+// pred[v] = lowest (dist[u], u) over tight edges u->v
+static void choosePred(int lo, int hi, int thread, void *arg) {
+   Step *s = arg;
+   const WCSR *g = s->g;
+   for (Vertex u = lo; u < hi; u++) {
+      long du = s->dist[u];
+      if (du == UNREACHED)
+         continue;
+      for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+         Vertex v = g->targets[e];
+         if (g->weights[e] <= 0 || du + g->weights[e] != s->dist[v])
+            continue;
+         Vertex cur = __atomic_load_n(&s->pred[v], __ATOMIC_RELAXED);
+         while (cur == -1 || du < s->dist[cur] || (du == s->dist[cur] && u < cur)) {
+            if (__atomic_compare_exchange_n(&s->pred[v], &cur, u, false,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+               break;
+         }
+      }
+   }
+}
+
+static void finishDist(int lo, int hi, int thread, void *arg) {
+   long *dist = arg;
+   for (int v = lo; v < hi; v++)
+      if (dist[v] == UNREACHED)
+         dist[v] = -1;
+}
+
+// relax one kind of edge out of frontier in parallel, then file every
+// vertex whose distance dropped under its new bucket
+static long step(Step *s, const Vertex *frontier, int n, bool heavy, int nThreads,
+                 VList *bucket, long nBuckets) {
+   s->frontier = frontier;
+   s->heavy = heavy;
+   parallelFor(n, RELAX_CHUNK, nThreads, relax, s);
+
+   long filed = 0;
+   for (int t = 0; t < nThreads; t++) {
+      VList *l = &s->out[t].list;
+      for (long i = 0; i < l->n; i++)
+         push(&bucket[s->dist[l->v[i]] / s->delta % nBuckets], l->v[i]);
+      filed += l->n;
+      l->n = 0;
+   }
+   return filed;
+}
+
+void deltaStepping(WCSR *g, Vertex src, long delta, int nThreads, long *dist, Vertex *pred) {
+   assert(g != NULL && src >= 0 && src < g->nV);
+   if (nThreads < 1)
+      nThreads = defaultThreads();
+   if (delta <= 0)                  // about one light edge per vertex on average
+      delta = g->nE > 0 ? (long)g->maxWeight * g->nV / g->nE : 1;
+   if (delta < 1)
+      delta = 1;
+
+   int nV = g->nV;
+   bool ownDist = dist == NULL;
+   if (ownDist)
+      dist = malloc((nV > 0 ? nV : 1) * sizeof(long));
+   long *seen = malloc((nV > 0 ? nV : 1) * sizeof(long));     // last bucket + 1 holding v
+   long *taken = malloc((nV > 0 ? nV : 1) * sizeof(long));    // last phase + 1 relaxing v
+   Vertex *frontier = malloc((nV > 0 ? nV : 1) * sizeof(Vertex));
+   Vertex *settled = malloc((nV > 0 ? nV : 1) * sizeof(Vertex));
+   assert(dist != NULL && seen != NULL && taken != NULL && frontier != NULL && settled != NULL);
+   for (Vertex v = 0; v < nV; v++) {
+      dist[v] = UNREACHED;
+      seen[v] = taken[v] = 0;
+   }
+
+   // every waiting vertex is within maxWeight of the current bucket, so a
+   // ring of buckets covering that span never wraps onto itself
+   long nBuckets = g->maxWeight / delta + 2;
+   VList *bucket = calloc(nBuckets, sizeof(VList));
+   Improved *out = calloc(nThreads, sizeof(Improved));
+   assert(bucket != NULL && out != NULL);
+   Step s = { g, delta, dist, NULL, false, out, pred };
+
+   dist[src] = 0;
+   push(&bucket[0], src);
+   long waiting = 1, phase = 0;
+   for (long i = 0; waiting > 0; i++) {
+      VList *b = &bucket[i % nBuckets];
+      int nSettled = 0;
+      while (b->n > 0) {
+         // take the live entries; stale ones have since moved to a lower bucket
+         int n = 0;
+         phase++;
+         for (long j = 0; j < b->n; j++) {
+            Vertex v = b->v[j];
+            if (dist[v] / delta == i && taken[v] != phase) {
+               taken[v] = phase;
+               frontier[n++] = v;
+               if (seen[v] != i + 1) {
+                  seen[v] = i + 1;
+                  settled[nSettled++] = v;
+               }
+            }
+         }
+         waiting -= b->n;
+         b->n = 0;
+         waiting += step(&s, frontier, n, false, nThreads, bucket, nBuckets);
+      }
+      waiting += step(&s, settled, nSettled, true, nThreads, bucket, nBuckets);
+   }
+
+   if (pred != NULL) {
+      for (Vertex v = 0; v < nV; v++)
+         pred[v] = -1;
+      parallelFor(nV, 1024, nThreads, choosePred, &s);
+   }
+   parallelFor(nV, 4096, nThreads, finishDist, dist);
+
+   for (long i = 0; i < nBuckets; i++)
+      free(bucket[i].v);
+   for (int t = 0; t < nThreads; t++)
+      free(out[t].list.v);
+   free(bucket);
+   free(out);
+   free(seen);
+   free(taken);
+   free(frontier);
+   free(settled);
+   if (ownDist)
+      free(dist);
+}
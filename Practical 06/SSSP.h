@@ -0,0 +1,15 @@
+// Single-source shortest paths over a WCSR view
+#ifndef SSSP_H
+#define SSSP_H
+
+#include "WCSR.h"
+
+// Parallel delta-stepping from src.  dist[v] = length of a shortest path
+// (-1 if unreachable); pred[v] = previous vertex on it (-1 for src and
+// unreachable vertices), the same one dijkstraSSSP picks: of all u with
+// dist[u] + weight(u,v) == dist[v], the lowest (dist[u], u).  Edges with
+// weight <= 0 are ignored as in dijkstraSSSP.  delta <= 0 picks a bucket
+// width from the weights and degrees; either array may be NULL.
+void deltaStepping(WCSR *, Vertex src, long delta, int nThreads, long *dist, Vertex *pred);
+
+#endif
@@ -0,0 +1,247 @@
+// Sorting: pattern-defeating quicksort, LSD radix sort and parallel merge sort
+//
+// The quicksort follows Peters' pdqsort: median-of-3 (ninther on large
+// inputs) pivots, a check for inputs that are already partitioned, a side
+// path for runs of equal elements, shuffles that break up patterns which
+// give lopsided partitions and heapsort once too many of those happen.
+// Partitions of up to NETWORK_MAX elements go through a sorting network.
+// The comparison sorts are written once in SortBody.h and instantiated for
+// int, KeyIndex and (for sortGeneric) pointers to elements.
+#include "Sort.h"
+#include "Parallel.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SMALL_SORT 24            // partitions up to this size are not split
+#define NETWORK_MAX 16           // ... and up to this size use the network
+#define NINTHER_AT 128           // larger partitions take the pivot from 9
+#define PARTIAL_LIMIT 8          // moves allowed to finish a sorted-looking partition
+#define MERGE_RUN_MIN 4096       // smallest run for the merge sort
+#define RADIX_MIN 2048           // sort*: radix sort from here ...
+#define PARALLEL_MIN 65536       // ... merge sort from here, if threads are spare
+
+// Batcher's odd-even merge sort for 16 inputs; dropping the comparators
+// that touch a position >= n leaves a network for n inputs
+#define NETWORK_SIZE 63
+static const unsigned char Network[NETWORK_SIZE][2] = {
+   {0, 1}, {2, 3}, {4, 5}, {6, 7}, {8, 9}, {10, 11}, {12, 13}, {14, 15},
+   {0, 2}, {1, 3}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {12, 14}, {13, 15},
+   {1, 2}, {5, 6}, {9, 10}, {13, 14},
+   {0, 4}, {1, 5}, {2, 6}, {3, 7}, {8, 12}, {9, 13}, {10, 14}, {11, 15},
+   {2, 4}, {3, 5}, {10, 12}, {11, 13},
+   {1, 2}, {3, 4}, {5, 6}, {9, 10}, {11, 12}, {13, 14},
+   {0, 8}, {1, 9}, {2, 10}, {3, 11}, {4, 12}, {5, 13}, {6, 14}, {7, 15},
+   {4, 8}, {5, 9}, {6, 10}, {7, 11},
+   {2, 4}, {3, 5}, {6, 8}, {7, 9}, {10, 12}, {11, 13},
+   {1, 2}, {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12}, {13, 14}
+};
+
+/* ---------- comparison sorts, one per element type ---------- */
+
+#define SORT_T int
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_NAME(f) f##Int
+#define SORT_MERGE
+#define SORT_RUN(a, n, ctx) sortInts(a, n, 1)
+#include "SortBody.h"
+
+#define SORT_T KeyIndex
+#define SORT_LESS(a, b) ((a).key < (b).key || ((a).key == (b).key && (a).index < (b).index))
+#define SORT_NAME(f) f##Pair
+#define SORT_MERGE
+#define SORT_RUN(a, n, ctx) sortKeyIndex(a, n, 1)
+#include "SortBody.h"
+
+typedef struct {
+   CompareFn cmp;
+   void     *ctx;
+} Generic;
+
+typedef const char *Element;
+
+#define SORT_T Element
+#define SORT_LESS(a, b) (((Generic *)ctx)->cmp((a), (b), ((Generic *)ctx)->ctx) < 0)
+#define SORT_NAME(f) f##Ptr
+#include "SortBody.h"
+
+static int threadsOrDefault(int nThreads) {
+   return nThreads > 0 ? nThreads : defaultThreads();
+}
+
+// (nearly) ascending or descending input is left to pdqsort, which takes
+// it in about one pass; radix sort needs its full passes whatever the order
+static bool presorted(long descents, long n) {
+   return descents < n / 16 || descents > n - n / 16;
+}
+
+uint64_t doubleKey(double x) {
+   uint64_t bits;
+   if (x == 0)
+      x = 0;                                   // -0.0 reads as 0.0
+   memcpy(&bits, &x, sizeof(bits));
+   // negatives: reverse their order; all of them below the non-negatives
+   return bits >> 63 ? ~bits : bits | (uint64_t)1 << 63;
+}
+
+/* ---------- generic ---------- */
+
+// sort pointers to the elements, then move each element once
+void sortGeneric(void *base, long n, size_t size, CompareFn cmp, void *ctx) {
+   if (n < 2)
+      return;
+   char *a = base;
+   Element *at = malloc(n * sizeof(Element));
+   char *hold = malloc(size);
+   assert(at != NULL && hold != NULL);
+   for (long i = 0; i < n; i++)
+      at[i] = a + i * size;
+   Generic g = {cmp, ctx};
+   pdqPtr(at, n, &g);
+
+   // position i gets the element now at at[i]; follow each cycle once
+   for (long i = 0; i < n; i++) {
+      if (at[i] == a + i * size)
+         continue;
+      memcpy(hold, a + i * size, size);
+      long j = i;
+      for (;;) {
+         long k = (at[j] - a) / size;
+         at[j] = a + j * size;
+         if (k == i) {
+            memcpy(a + j * size, hold, size);
+            break;
+         }
+         memcpy(a + j * size, a + k * size, size);
+         j = k;
+      }
+   }
+   free(hold);
+   free(at);
+}
+
+/* ---------- int ---------- */
+
+void pdqSortInts(int *a, long n) {
+   pdqInt(a, n, NULL);
+}
+
+void mergeSortInts(int *a, long n, int nThreads) {
+   mergeSortInt(a, n, threadsOrDefault(nThreads), NULL);
+}
+
+// 4 passes of 8 bits over the key with its sign bit flipped; passes where
+// every key has the same digit are skipped
+void radixSortInts(int *a, long n) {
+   if (n < 2)
+      return;
+   long (*count)[256] = calloc(4, sizeof(*count));
+   int *buf = malloc(n * sizeof(int));
+   assert(count != NULL && buf != NULL);
+   for (long i = 0; i < n; i++) {
+      uint32_t k = (uint32_t)a[i] ^ 0x80000000u;
+      for (int d = 0; d < 4; d++)
+         count[d][(k >> (8 * d)) & 0xff]++;
+   }
+
+   int *src = a, *dst = buf;
+   for (int d = 0; d < 4; d++) {
+      long *c = count[d];
+      if (c[((uint32_t)a[0] ^ 0x80000000u) >> (8 * d) & 0xff] == n)
+         continue;
+      long at = 0;
+      for (int b = 0; b < 256; b++) {
+         long m = c[b];
+         c[b] = at;
+         at += m;
+      }
+      for (long i = 0; i < n; i++) {
+         uint32_t k = (uint32_t)src[i] ^ 0x80000000u;
+         dst[c[(k >> (8 * d)) & 0xff]++] = src[i];
+      }
+      int *t = src;
+      src = dst;
+      dst = t;
+   }
+   if (src != a)
+      memcpy(a, src, n * sizeof(int));
+   free(buf);
+   free(count);
+}
+
+void sortInts(int *a, long n, int nThreads) {
+   // only an input big enough to split asks how many CPUs there are
+   if (n >= PARALLEL_MIN && (nThreads = threadsOrDefault(nThreads)) > 1)
+      mergeSortInt(a, n, nThreads, NULL);
+   else if (n >= RADIX_MIN && !presorted(descentsInt(a, n, NULL), n))
+      radixSortInts(a, n);
+   else
+      pdqInt(a, n, NULL);
+}
+
+/* ---------- KeyIndex ---------- */
+
+void pdqSortKeyIndex(KeyIndex *a, long n) {
+   pdqPair(a, n, NULL);
+}
+
+void mergeSortKeyIndex(KeyIndex *a, long n, int nThreads) {
+   mergeSortPair(a, n, threadsOrDefault(nThreads), NULL);
+}
+
+// digit d: bytes 0..3 of the index (sign flipped), then bytes 0..7 of the key
+static inline unsigned pairDigit(KeyIndex e, int d) {
+   if (d < 4)
+      return ((uint32_t)e.index ^ 0x80000000u) >> (8 * d) & 0xff;
+   return e.key >> (8 * (d - 4)) & 0xff;
+}
+
+// 8-bit digits of the index (unless the indices are ascending already, as
+// the passes are stable) and then of the key; constant digits are skipped
+void radixSortKeyIndex(KeyIndex *a, long n) {
+   if (n < 2)
+      return;
+   long (*count)[256] = calloc(12, sizeof(*count));
+   KeyIndex *buf = malloc(n * sizeof(KeyIndex));
+   assert(count != NULL && buf != NULL);
+   bool ascending = true;
+   for (long i = 0; i < n; i++) {
+      for (int d = 0; d < 12; d++)
+         count[d][pairDigit(a[i], d)]++;
+      if (i > 0 && a[i].index < a[i - 1].index)
+         ascending = false;
+   }
+
+   KeyIndex *src = a, *dst = buf;
+   for (int d = ascending ? 4 : 0; d < 12; d++) {
+      long *c = count[d];
+      if (c[pairDigit(a[0], d)] == n)
+         continue;
+      long at = 0;
+      for (int b = 0; b < 256; b++) {
+         long m = c[b];
+         c[b] = at;
+         at += m;
+      }
+      for (long i = 0; i < n; i++)
+         dst[c[pairDigit(src[i], d)]++] = src[i];
+      KeyIndex *t = src;
+      src = dst;
+      dst = t;
+   }
+   if (src != a)
+      memcpy(a, src, n * sizeof(KeyIndex));
+   free(buf);
+   free(count);
+}
+
+void sortKeyIndex(KeyIndex *a, long n, int nThreads) {
+   // only an input big enough to split asks how many CPUs there are
+   if (n >= PARALLEL_MIN && (nThreads = threadsOrDefault(nThreads)) > 1)
+      mergeSortPair(a, n, nThreads, NULL);
+   else if (n >= RADIX_MIN && !presorted(descentsPair(a, n, NULL), n))
+      radixSortKeyIndex(a, n);
+   else
+      pdqPair(a, n, NULL);
+}
@@ -0,0 +1,35 @@
+// Sorting: pattern-defeating quicksort, LSD radix sort and parallel merge sort
+//
+// None of the sorts is stable.  KeyIndex pairs are ordered by key and then
+// by index, so with distinct indices every sort gives the same order.
+// nThreads <= 0 means all CPUs.
+#ifndef SORT_H
+#define SORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// < 0, 0 or > 0 as *a goes before, with or after *b; ctx is passed through
+typedef int (*CompareFn)(const void *a, const void *b, void *ctx);
+
+typedef struct KeyIndex {
+   uint64_t key;
+   int      index;
+} KeyIndex;
+
+// x < y exactly when doubleKey(x) < doubleKey(y) (not for NaN; -0.0 == 0.0)
+uint64_t doubleKey(double);
+
+void sortGeneric(void *base, long n, size_t size, CompareFn, void *ctx);
+
+void sortInts(int *, long n, int nThreads);          // picks one of these:
+void pdqSortInts(int *, long n);
+void radixSortInts(int *, long n);
+void mergeSortInts(int *, long n, int nThreads);
+
+void sortKeyIndex(KeyIndex *, long n, int nThreads); // picks one of these:
+void pdqSortKeyIndex(KeyIndex *, long n);
+void radixSortKeyIndex(KeyIndex *, long n);
+void mergeSortKeyIndex(KeyIndex *, long n, int nThreads);
+
+#endif
@@ -0,0 +1,329 @@
+// Sort.c internals: comparison sorts over one element type
+//
+// Included by Sort.c once per element type, after defining
+//    SORT_T           the element type
+//    SORT_LESS(a, b)  true if SORT_T value a goes before b; may use ctx
+//    SORT_NAME(f)     the name f gets for this type
+//    SORT_MERGE       (optional) to add descents() and the parallel merge
+//                     sort, which sorts its runs with SORT_RUN(a, n, ctx)
+//                     if that is defined
+// Every function takes the ctx that SORT_LESS may use.
+
+#define SORT_SWAP(x, y) do { SORT_T t_ = (x); (x) = (y); (y) = t_; } while (0)
+
+// compare-exchange without a data-dependent branch (becomes cmov)
+#define SORT_CSWAP(x, y) do {                                 \
+      SORT_T a_ = (x), b_ = (y);                              \
+      bool lt_ = SORT_LESS(b_, a_);                           \
+      (x) = lt_ ? b_ : a_;                                    \
+      (y) = lt_ ? a_ : b_;                                    \
+   } while (0)
+
+/* ---------- small inputs ---------- */
+
+static void SORT_NAME(insertion)(SORT_T *a, long n, void *ctx) {
+   for (long i = 1; i < n; i++) {
+      SORT_T x = a[i];
+      long j = i;
+      for (; j > 0 && SORT_LESS(x, a[j - 1]); j--)
+         a[j] = a[j - 1];
+      a[j] = x;
+   }
+}
+
+// up to NETWORK_MAX elements through the sorting network
+static void SORT_NAME(network)(SORT_T *a, long n, void *ctx) {
+   for (const unsigned char (*c)[2] = Network; c < Network + NETWORK_SIZE; c++)
+      if (c[0][1] < n)
+         SORT_CSWAP(a[c[0][0]], a[c[0][1]]);
+}
+
+static void SORT_NAME(small)(SORT_T *a, long n, void *ctx) {
+   if (n <= NETWORK_MAX)
+      SORT_NAME(network)(a, n, ctx);
+   else
+      SORT_NAME(insertion)(a, n, ctx);
+}
+
+// insertion sort that gives up (returning false) after moving PARTIAL_LIMIT elements
+static bool SORT_NAME(partialInsertion)(SORT_T *a, long n, void *ctx) {
+   long moved = 0;
+   for (long i = 1; i < n; i++) {
+      if (!SORT_LESS(a[i], a[i - 1]))
+         continue;
+      SORT_T x = a[i];
+      long j = i;
+      do {
+         a[j] = a[j - 1];
+         j--;
+      } while (j > 0 && SORT_LESS(x, a[j - 1]));
+      a[j] = x;
+      moved += i - j;
+      if (moved > PARTIAL_LIMIT)
+         return false;
+   }
+   return true;
+}
+
+/* ---------- heapsort, the worst-case fallback ---------- */
+
+static void SORT_NAME(siftDown)(SORT_T *a, long i, long n, void *ctx) {
+   SORT_T x = a[i];
+   for (;;) {
+      long child = 2 * i + 1;
+      if (child >= n)
+         break;
+      if (child + 1 < n && SORT_LESS(a[child], a[child + 1]))
+         child++;
+      if (!SORT_LESS(x, a[child]))
+         break;
+      a[i] = a[child];
+      i = child;
+   }
+   a[i] = x;
+}
+
+static void SORT_NAME(heapSort)(SORT_T *a, long n, void *ctx) {
+   for (long i = n / 2; i-- > 0; )
+      SORT_NAME(siftDown)(a, i, n, ctx);
+   for (long i = n - 1; i > 0; i--) {
+      SORT_SWAP(a[0], a[i]);
+      SORT_NAME(siftDown)(a, 0, i, ctx);
+   }
+}
+
+/* ---------- pattern-defeating quicksort ---------- */
+
+// leaves a[i] <= a[j] <= a[k]
+static void SORT_NAME(sort3)(SORT_T *a, long i, long j, long k, void *ctx) {
+   SORT_CSWAP(a[i], a[j]);
+   SORT_CSWAP(a[j], a[k]);
+   SORT_CSWAP(a[i], a[j]);
+}
+
+// Pivot a[0]; some later element is >= it.  Elements < pivot go left of
+// the returned position, the rest right of it; *already is set if nothing
+// had to be swapped.  (SORT_LESS may read its arguments twice, hence the
+// do-while scans.)
+static long SORT_NAME(partitionRight)(SORT_T *a, long n, bool *already, void *ctx) {
+   SORT_T pivot = a[0];
+   long first = 0, last = n;
+   do first++; while (SORT_LESS(a[first], pivot));
+   if (first == 1)
+      do last--; while (first < last && !SORT_LESS(a[last], pivot));
+   else                                        // a[first-1] < pivot stops the scan
+      do last--; while (!SORT_LESS(a[last], pivot));
+   *already = first >= last;
+   while (first < last) {
+      SORT_SWAP(a[first], a[last]);
+      do first++; while (SORT_LESS(a[first], pivot));
+      do last--; while (!SORT_LESS(a[last], pivot));
+   }
+   long p = first - 1;
+   a[0] = a[p];
+   a[p] = pivot;
+   return p;
+}
+
+// Pivot a[0] equals the element before a; nothing here is smaller.  Puts
+// the elements equal to the pivot on the left and returns the last of them.
+static long SORT_NAME(partitionLeft)(SORT_T *a, long n, void *ctx) {
+   SORT_T pivot = a[0];
+   long first = 0, last = n;
+   do last--; while (SORT_LESS(pivot, a[last]));
+   if (last + 1 == n)
+      do first++; while (first < last && !SORT_LESS(pivot, a[first]));
+   else
+      do first++; while (!SORT_LESS(pivot, a[first]));
+   while (first < last) {
+      SORT_SWAP(a[first], a[last]);
+      do last--; while (SORT_LESS(pivot, a[last]));
+      do first++; while (!SORT_LESS(pivot, a[first]));
+   }
+   a[0] = a[last];
+   a[last] = pivot;
+   return last;
+}
+
+// swap a few elements of a lopsided side away from its ends
+static void SORT_NAME(scatter)(SORT_T *a, long n, void *ctx) {
+   long q = n / 4;
+   SORT_SWAP(a[0], a[q]);
+   SORT_SWAP(a[n - 1], a[n - q]);
+   if (n > NINTHER_AT) {
+      SORT_SWAP(a[1], a[q + 1]);
+      SORT_SWAP(a[2], a[q + 2]);
+      SORT_SWAP(a[n - 2], a[n - q - 1]);
+      SORT_SWAP(a[n - 3], a[n - q - 2]);
+   }
+}
+
+// leftmost: no element before a that is <= all of a; badAllowed: lopsided
+// partitions left before switching to heapsort
+static void SORT_NAME(pdqLoop)(SORT_T *a, long n, int badAllowed, bool leftmost, void *ctx) {
+   while (n > SMALL_SORT) {
+      long half = n / 2;
+      if (n > NINTHER_AT) {
+         SORT_NAME(sort3)(a, 0, half, n - 1, ctx);
+         SORT_NAME(sort3)(a, 1, half - 1, n - 2, ctx);
+         SORT_NAME(sort3)(a, 2, half + 1, n - 3, ctx);
+         SORT_NAME(sort3)(a, half - 1, half, half + 1, ctx);
+         SORT_SWAP(a[0], a[half]);
+      } else {
+         SORT_NAME(sort3)(a, half, 0, n - 1, ctx);
+      }
+
+      // many equal elements: the ones equal to the pivot are done
+      if (!leftmost && !SORT_LESS(a[-1], a[0])) {
+         long p = SORT_NAME(partitionLeft)(a, n, ctx);
+         a += p + 1;
+         n -= p + 1;
+         continue;
+      }
+
+      bool already;
+      long p = SORT_NAME(partitionRight)(a, n, &already, ctx);
+      long left = p, right = n - p - 1;
+      if (left < n / 8 || right < n / 8) {
+         if (--badAllowed == 0) {
+            SORT_NAME(heapSort)(a, n, ctx);
+            return;
+         }
+         if (left >= SMALL_SORT)
+            SORT_NAME(scatter)(a, left, ctx);
+         if (right >= SMALL_SORT)
+            SORT_NAME(scatter)(a + p + 1, right, ctx);
+      } else if (already && SORT_NAME(partialInsertion)(a, left, ctx)
+                 && SORT_NAME(partialInsertion)(a + p + 1, right, ctx)) {
+         return;                               // looked sorted, and was
+      }
+
+      SORT_NAME(pdqLoop)(a, left, badAllowed, leftmost, ctx);
+      a += p + 1;
+      n = right;
+      leftmost = false;
+   }
+   SORT_NAME(small)(a, n, ctx);
+}
+
+static void SORT_NAME(pdq)(SORT_T *a, long n, void *ctx) {
+   int log2n = 0;
+   for (long m = n; m > 1; m /= 2)
+      log2n++;
+   SORT_NAME(pdqLoop)(a, n, log2n + 1, true, ctx);
+}
+
+#ifdef SORT_MERGE
+
+// #places where an element goes before the one ahead of it
+static long SORT_NAME(descents)(const SORT_T *a, long n, void *ctx) {
+   long d = 0;
+   for (long i = 1; i < n; i++)
+      d += SORT_LESS(a[i], a[i - 1]);
+   return d;
+}
+
+/* ---------- parallel merge sort ---------- */
+
+typedef struct {
+   SORT_T *src, *dst;
+   long   *bounds;                             // run r: bounds[r] .. bounds[r+1]-1
+   int     nRuns;
+   int     step;                               // runs per half of a merge
+   int     pieces;                             // tasks per merge
+   void   *ctx;
+} SORT_NAME(Merge);
+
+#ifndef SORT_RUN
+#define SORT_RUN(a, n, ctx) SORT_NAME(pdq)(a, n, ctx)
+#endif
+
+static void SORT_NAME(sortRuns)(int lo, int hi, int thread, void *arg) {
+   SORT_NAME(Merge) *m = arg;
+   for (int r = lo; r < hi; r++)
+      SORT_RUN(m->src + m->bounds[r], m->bounds[r + 1] - m->bounds[r], m->ctx);
+}
+
+// #elements of x among the first k of the merge of x[0..nx-1] and y[0..ny-1]
+static long SORT_NAME(coRank)(long k, const SORT_T *x, long nx, const SORT_T *y, long ny, void *ctx) {
+   long lo = k > ny ? k - ny : 0, hi = k < nx ? k : nx;
+   while (lo < hi) {
+      long i = lo + (hi - lo) / 2;
+      if (!SORT_LESS(y[k - i - 1], x[i]))
+         lo = i + 1;
+      else
+         hi = i;
+   }
+   return lo;
+}
+
+// task t writes one slice of the output of merge t / pieces
+static void SORT_NAME(mergeSlices)(int lo, int hi, int thread, void *arg) {
+   SORT_NAME(Merge) *m = arg;
+   void *ctx = m->ctx;
+   for (int t = lo; t < hi; t++) {
+      int r = t / m->pieces * 2 * m->step, piece = t % m->pieces;
+      int mid = r + m->step < m->nRuns ? r + m->step : m->nRuns;
+      int end = mid + m->step < m->nRuns ? mid + m->step : m->nRuns;
+      long base = m->bounds[r];
+      const SORT_T *x = m->src + base, *y = m->src + m->bounds[mid];
+      long nx = m->bounds[mid] - base, ny = m->bounds[end] - m->bounds[mid];
+      long k0 = (nx + ny) * piece / m->pieces, k1 = (nx + ny) * (piece + 1) / m->pieces;
+      long i = SORT_NAME(coRank)(k0, x, nx, y, ny, ctx), j = k0 - i;
+      long iEnd = SORT_NAME(coRank)(k1, x, nx, y, ny, ctx), jEnd = k1 - iEnd;
+      SORT_T *out = m->dst + base + k0;
+      while (i < iEnd && j < jEnd) {
+         bool fromY = SORT_LESS(y[j], x[i]);
+         *out++ = fromY ? y[j] : x[i];
+         j += fromY;
+         i += !fromY;
+      }
+      while (i < iEnd)
+         *out++ = x[i++];
+      while (j < jEnd)
+         *out++ = y[j++];
+   }
+}
+
+// sort runs in parallel, then merge them pairwise, splitting each merge so
+// that every level keeps all threads busy
+static void SORT_NAME(mergeSort)(SORT_T *a, long n, int nThreads, void *ctx) {
+   long nRuns = n / MERGE_RUN_MIN;
+   if (nRuns > 4L * nThreads)
+      nRuns = 4L * nThreads;
+   if (nRuns < 2) {
+      SORT_NAME(pdq)(a, n, ctx);
+      return;
+   }
+   SORT_NAME(Merge) m = { a, malloc(n * sizeof(SORT_T)), malloc((nRuns + 1) * sizeof(long)),
+                          (int)nRuns, 1, 1, ctx };
+   assert(m.dst != NULL && m.bounds != NULL);
+   for (int r = 0; r <= m.nRuns; r++)
+      m.bounds[r] = n * r / m.nRuns;
+   parallelFor(m.nRuns, 1, nThreads, SORT_NAME(sortRuns), &m);
+
+   for (; m.step < m.nRuns; m.step *= 2) {
+      int merges = (m.nRuns + 2 * m.step - 1) / (2 * m.step);
+      m.pieces = (2 * nThreads + merges - 1) / merges;
+      parallelFor(merges * m.pieces, 1, nThreads, SORT_NAME(mergeSlices), &m);
+      SORT_T *t = m.src;
+      m.src = m.dst;
+      m.dst = t;
+   }
+   if (m.src != a) {
+      memcpy(a, m.src, n * sizeof(SORT_T));
+      m.dst = m.src;
+   }
+   free(m.dst);
+   free(m.bounds);
+}
+
+#endif
+
+#undef SORT_SWAP
+#undef SORT_CSWAP
+#undef SORT_T
+#undef SORT_LESS
+#undef SORT_NAME
+#undef SORT_MERGE
+#undef SORT_RUN
@@ -0,0 +1,66 @@
+// Union-find ADT
+// Path compression (halving) and union by rank: O(m alpha(n)) for m operations
+#include "UnionFind.h"
+#include <assert.h>
+#include <stdlib.h>
+
+typedef struct UFRep {
+   int           *parent;   // parent[v] == v for a representative
+   unsigned char *rank;     // upper bound on the height of each tree
+   int            n;        // #elements
+   int            nSets;    // #disjoint sets
+} UFRep;
+
+UnionFind newUnionFind(int n) {
+   assert(n >= 0);
+
+   UnionFind uf = malloc(sizeof(UFRep));
+   assert(uf != NULL);
+   uf->parent = malloc((n > 0 ? n : 1) * sizeof(int));
+   uf->rank = calloc(n > 0 ? n : 1, sizeof(unsigned char));
+   assert(uf->parent != NULL && uf->rank != NULL);
+   for (int v = 0; v < n; v++)
+      uf->parent[v] = v;
+   uf->n = n;
+   uf->nSets = n;
+   return uf;
+}
+
+int ufFind(UnionFind uf, int v) {
+   assert(uf != NULL && v >= 0 && v < uf->n);
+
+   while (uf->parent[v] != v) {
+      uf->parent[v] = uf->parent[uf->parent[v]];   // point to grandparent
+      v = uf->parent[v];
+   }
+   return v;
+}
+
+bool ufUnion(UnionFind uf, int v, int w) {
+   v = ufFind(uf, v);
+   w = ufFind(uf, w);
+   if (v == w)
+      return false;
+
+   // hang the shallower tree under the deeper one
+   if (uf->rank[v] < uf->rank[w]) {
+      int t = v; v = w; w = t;
+   }
+   uf->parent[w] = v;
+   if (uf->rank[v] == uf->rank[w])
+      uf->rank[v]++;
+   uf->nSets--;
+   return true;
+}
+
+int ufSets(UnionFind uf) {
+   assert(uf != NULL);
+   return uf->nSets;
+}
+
+void freeUnionFind(UnionFind uf) {
+   assert(uf != NULL);
+   free(uf->parent);
+   free(uf->rank);
+   free(uf);
+}
@@ -0,0 +1,45 @@
+// Compressed sparse row view of a WGraph
+#include "WCSR.h"
+#include <assert.h>
+#include <stdlib.h>
+
+WCSR *newWCSR(Graph g) {
+   assert(g != NULL);
+   int nV = numOfVertices(g);
+
+   WCSR *c = malloc(sizeof(WCSR));
+   assert(c != NULL);
+   c->nV = nV;
+   c->offsets = malloc((nV + 1) * sizeof(long));
+   assert(c->offsets != NULL);
+
+   // row sizes come straight from the maintained out-degrees
+   c->offsets[0] = 0;
+   for (Vertex v = 0; v < nV; v++)
+      c->offsets[v + 1] = c->offsets[v] + degree(g, v);
+   c->nE = c->offsets[nV];
+
+   c->targets = malloc((c->nE > 0 ? c->nE : 1) * sizeof(Vertex));
+   c->weights = malloc((c->nE > 0 ? c->nE : 1) * sizeof(int));
+   assert(c->targets != NULL && c->weights != NULL);
+   c->maxWeight = 0;
+   for (Vertex v = 0; v < nV; v++) {
+      long i = c->offsets[v];
+      for (Vertex w = firstNeighbour(g, v); w != -1; w = nextNeighbour(g, v, w)) {
+         c->targets[i] = w;
+         c->weights[i] = edgeWeight(g, v, w);
+         if (c->weights[i] > c->maxWeight)
+            c->maxWeight = c->weights[i];
+         i++;
+      }
+   }
+   return c;
+}
+
+void freeWCSR(WCSR *c) {
+   assert(c != NULL);
+   free(c->offsets);
+   free(c->targets);
+   free(c->weights);
+   free(c);
+}
@@ -0,0 +1,19 @@
+// Compressed sparse row view of a WGraph
+#ifndef WCSR_H
+#define WCSR_H
+
+#include "WGraph.h"
+
+typedef struct WCSR {
+   int     nV;        // #vertices
+   long    nE;        // #edges
+   long   *offsets;   // out-edges of v: index offsets[v] .. offsets[v+1]-1
+   Vertex *targets;   // ascending within each row
+   int    *weights;   // weights[i] belongs to the edge to targets[i]
+   int     maxWeight; // largest weight (0 if no edges)
+} WCSR;
+
+WCSR *newWCSR(Graph);  // snapshot of the graph's current edges
+void  freeWCSR(WCSR *);
+
+#endif
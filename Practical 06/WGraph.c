@@ -1,35 +1,159 @@
 // Weighted Directed Graph ADT
-// Adjacency Matrix Representation ... COMP9024 25T1
+// Adaptive Representation: sorted out-edge arrays or adjacency matrix ... COMP9024 25T1
+//
+// A graph starts with an array of out-edges per vertex, sorted by target.
+// When its density E/V^2 rises past the graph's threshold it moves to an
+// adjacency matrix, and back once the density falls below a quarter of the
+// threshold, so each O(V^2 + E) switch is paid for by the Θ(threshold * V^2)
+// edge changes since the previous one.
 #include "WGraph.h"
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 
+#define DEFAULT_THRESHOLD 0.25   // arrays of (target, weight) with slack cost about this much
+#define HYSTERESIS 4             // back to arrays below threshold / 4
+
+typedef struct Arc {
+   Vertex w;                     // target
+   int    weight;
+} Arc;
+
+typedef struct ArcList {
+   Arc *arcs;                    // out-edges, ascending by target
+   int  n;                       // #out-edges
+   int  cap;                     // allocated length
+} ArcList;
+
 typedef struct GraphRep {
-   int **edges;  // adjacency matrix storing positive weights
-		 // 0 if nodes not adjacent
-   int nV;       // #vertices
-   int nE;       // #edges
+   int     *edges;     // dense: adjacency matrix, row by row, storing weights
+		       // NO_EDGE if nodes not adjacent
+   ArcList *out;       // sparse: out-edges of each vertex
+   int     *degree;    // #out-edges of each vertex
+   int      nV;        // #vertices
+   int      nE;        // #edges
+   double   threshold; // density at which to switch to the matrix
+   long     filling;   // edges newGraphSized expects; no switch before nE reaches it
 } GraphRep;
 
+#define CELL(g,v,w)  ((g)->edges[(size_t)(v) * (g)->nV + (w)])
+#define DENSE_AT(g)  ((g)->threshold * (g)->nV * (double)(g)->nV)
+#define SPARSE_AT(g) (DENSE_AT(g) / HYSTERESIS)
+
+/* ---------- representations ---------- */
+
+// first index in l->arcs with target >= w
+static int search(const ArcList *l, Vertex w) {
+   int lo = 0, hi = l->n;
+   while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (l->arcs[mid].w < w)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+static int weightOf(Graph g, Vertex v, Vertex w) {
+   if (g->edges != NULL)
+      return CELL(g,v,w);
+   const ArcList *l = &g->out[v];
+   int i = search(l, w);
+   return i < l->n && l->arcs[i].w == w ? l->arcs[i].weight : NO_EDGE;
+}
+
+static int *newMatrix(int V) {
+   size_t cells = (size_t)V * V;
+   int *m = malloc((cells > 0 ? cells : 1) * sizeof(int));
+   assert(m != NULL);
+   for (size_t i = 0; i < cells; i++)
+      m[i] = NO_EDGE;
+   return m;
+}
+
+static void toDense(Graph g) {
+   g->edges = newMatrix(g->nV);
+   for (Vertex v = 0; v < g->nV; v++) {
+      for (int i = 0; i < g->out[v].n; i++)
+         CELL(g, v, g->out[v].arcs[i].w) = g->out[v].arcs[i].weight;
+      free(g->out[v].arcs);
+   }
+   free(g->out);
+   g->out = NULL;
+}
+
+static void toSparse(Graph g) {
+   g->out = calloc(g->nV > 0 ? g->nV : 1, sizeof(ArcList));
+   assert(g->out != NULL);
+   for (Vertex v = 0; v < g->nV; v++) {
+      ArcList *l = &g->out[v];
+      for (Vertex w = 0; w < g->nV; w++)
+         l->cap += CELL(g,v,w) != NO_EDGE;
+      l->arcs = malloc((l->cap > 0 ? l->cap : 1) * sizeof(Arc));
+      assert(l->arcs != NULL);
+      for (Vertex w = 0; w < g->nV; w++)
+         if (CELL(g,v,w) != NO_EDGE)
+            l->arcs[l->n++] = (Arc){ w, CELL(g,v,w) };
+   }
+   free(g->edges);
+   g->edges = NULL;
+}
+
+// switch representation if the density has left the current one's range;
+// a graph still filling up to its expected size keeps its representation
+static void rebalance(Graph g) {
+   if (g->nE < g->filling)
+      return;
+   g->filling = 0;
+   if (g->edges == NULL && g->nE > DENSE_AT(g))
+      toDense(g);
+   else if (g->edges != NULL && g->nE < SPARSE_AT(g))
+      toSparse(g);
+}
+
 Graph newGraph(int V) {
    assert(V >= 0);
-   int i;
 
    Graph g = malloc(sizeof(GraphRep));
    assert(g != NULL);
    g->nV = V;
    g->nE = 0;
+   g->threshold = DEFAULT_THRESHOLD;
+   g->filling = 0;
+
+   // every vertex starts with an empty out-edge array
+   g->edges = NULL;
+   g->out = calloc(V > 0 ? V : 1, sizeof(ArcList));
+   g->degree = calloc(V > 0 ? V : 1, sizeof(int));
+   assert(g->out != NULL && g->degree != NULL);
+
+   return g;
+}
 
-   // allocate memory for each row
-   g->edges = malloc(V * sizeof(int *));
-   assert(g->edges != NULL);
-   // allocate memory for each column and initialise with 0
-   for (i = 0; i < V; i++) {
-      g->edges[i] = calloc(V, sizeof(int));
-      assert(g->edges[i] != NULL);
+// start in the representation suited to about nE edges, and keep it until
+// that many are in, so the first inserts do not switch back and forth
+Graph newGraphSized(int V, long nE) {
+   Graph g = newGraph(V);
+   if (nE > DENSE_AT(g)) {
+      free(g->out);
+      g->out = NULL;
+      g->edges = newMatrix(V);
+      g->filling = nE;
    }
+   return g;
+}
+
+// insert edges in order, so a repeated pair keeps its first weight
+Graph newGraphFromEdges(int V, const Edge *edges, long nE) {
+   assert(nE >= 0 && (edges != NULL || nE == 0));
 
+   Graph g = newGraphSized(V, nE);
+   for (long i = 0; i < nE; i++)
+      insertEdge(g, edges[i]);
+   g->filling = 0;
+   rebalance(g);                  // repeated pairs may have left it too sparse
    return g;
 }
 
@@ -45,25 +169,109 @@ int validV(Graph g, Vertex v) {
 void insertEdge(Graph g, Edge e) {
    assert(g != NULL && validV(g,e.v) && validV(g,e.w));
 
-   if (g->edges[e.v][e.w] == 0) {   // edge e not in graph
-      g->edges[e.v][e.w] = e.weight;
+   assert(e.weight != NO_EDGE);
+
+   if (weightOf(g, e.v, e.w) == NO_EDGE) {   // edge e not in graph
+      if (g->edges != NULL) {
+         CELL(g,e.v,e.w) = e.weight;
+      } else {
+         ArcList *l = &g->out[e.v];
+         if (l->n == l->cap) {
+            l->cap = l->cap > 0 ? 2 * l->cap : 4;
+            l->arcs = realloc(l->arcs, l->cap * sizeof(Arc));
+            assert(l->arcs != NULL);
+         }
+         int i = search(l, e.w);
+         memmove(l->arcs + i + 1, l->arcs + i, (l->n - i) * sizeof(Arc));
+         l->arcs[i] = (Arc){ e.w, e.weight };
+         l->n++;
+      }
+      g->degree[e.v]++;
       g->nE++;
+      rebalance(g);
    }
 }
 
 void removeEdge(Graph g, Edge e) {
    assert(g != NULL && validV(g,e.v) && validV(g,e.w));
 
-   if (g->edges[e.v][e.w] != 0) {   // edge e in graph
-      g->edges[e.v][e.w] = 0;
+   if (weightOf(g, e.v, e.w) != NO_EDGE) {   // edge e in graph
+      if (g->edges != NULL) {
+         CELL(g,e.v,e.w) = NO_EDGE;
+      } else {
+         ArcList *l = &g->out[e.v];
+         int i = search(l, e.w);
+         memmove(l->arcs + i, l->arcs + i + 1, (l->n - i - 1) * sizeof(Arc));
+         l->n--;
+      }
+      g->degree[e.v]--;
       g->nE--;
+      rebalance(g);
    }
 }
 
 int adjacent(Graph g, Vertex v, Vertex w) {
    assert(g != NULL && validV(g,v) && validV(g,w));
 
-   return g->edges[v][w];
+   int weight = weightOf(g, v, w);
+   return weight != NO_EDGE ? weight : 0;
+}
+
+int edgeWeight(Graph g, Vertex v, Vertex w) {
+   assert(g != NULL && validV(g,v) && validV(g,w));
+
+   return weightOf(g, v, w);
+}
+
+int degree(Graph g, Vertex v) {
+   assert(g != NULL && validV(g,v));
+
+   return g->degree[v];
+}
+
+Vertex firstNeighbour(Graph g, Vertex v) {
+   return nextNeighbour(g, v, -1);
+}
+
+// dense: scan row v past w; sparse: binary search v's out-edges
+Vertex nextNeighbour(Graph g, Vertex v, Vertex w) {
+   assert(g != NULL && validV(g,v) && w >= -1 && w < g->nV);
+
+   if (g->edges == NULL) {
+      const ArcList *l = &g->out[v];
+      int i = search(l, w + 1);
+      return i < l->n ? l->arcs[i].w : -1;
+   }
+   for (w++; w < g->nV; w++)
+      if (CELL(g,v,w) != NO_EDGE)
+         return w;
+   return -1;
+}
+
+void setDensityThreshold(Graph g, double density) {
+   assert(g != NULL && density > 0);
+
+   g->threshold = density;
+   g->filling = 0;
+   rebalance(g);
+}
+
+GraphStats graphStats(Graph g) {
+   assert(g != NULL);
+
+   GraphStats s;
+   s.dense = g->edges != NULL;
+   s.nV = g->nV;
+   s.nE = g->nE;
+   s.bytes = sizeof(GraphRep) + (size_t)g->nV * sizeof(int);
+   if (s.dense) {
+      s.bytes += (size_t)g->nV * g->nV * sizeof(int);
+   } else {
+      s.bytes += (size_t)g->nV * sizeof(ArcList);
+      for (Vertex v = 0; v < g->nV; v++)
+         s.bytes += (size_t)g->out[v].cap * sizeof(Arc);
+   }
+   return s;
 }
 
 void showGraph(Graph g) {
@@ -73,17 +281,20 @@ void showGraph(Graph g) {
     printf("Number of vertices: %d\n", g->nV);
     printf("Number of edges: %d\n", g->nE);
     for (i = 0; i < g->nV; i++)
-       for (j = 0; j < g->nV; j++)
-	  if (g->edges[i][j] != 0)
-	     printf("Edge %d - %d: %d\n", i, j, g->edges[i][j]);
+       for (j = firstNeighbour(g, i); j != -1; j = nextNeighbour(g, i, j))
+	  printf("Edge %d - %d: %d\n", i, j, weightOf(g, i, j));
 }
 
 void freeGraph(Graph g) {
    assert(g != NULL);
 
-   int i;
-   for (i = 0; i < g->nV; i++)
-      free(g->edges[i]);
-   free(g->edges);
+   if (g->edges != NULL) {
+      free(g->edges);
+   } else {
+      for (int i = 0; i < g->nV; i++)
+         free(g->out[i].arcs);
+      free(g->out);
+   }
+   free(g->degree);
    free(g);
-}
\ No newline at end of file
+}
\ No newline at end of file
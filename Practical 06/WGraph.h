@@ -1,4 +1,10 @@
 // Weighted Graph ADT interface ... COMP9024 25T1
+#ifndef WGRAPH_H
+#define WGRAPH_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
 
 typedef struct GraphRep *Graph;
 
@@ -12,10 +18,30 @@ typedef struct Edge {
    int    weight;
 } Edge;
 
+#define NO_EDGE INT_MIN   // edgeWeight of a pair that is not adjacent; not a valid weight
+
+// current representation of a graph and the heap memory it holds
+typedef struct GraphStats {
+   bool   dense;   // adjacency matrix (true) or sorted out-edge arrays (false)
+   int    nV;
+   int    nE;
+   size_t bytes;
+} GraphStats;
+
 Graph newGraph(int);
+Graph newGraphSized(int, long);         // expecting about this many edges
+Graph newGraphFromEdges(int, const Edge *, long);  // bulk build, in any order
 int   numOfVertices(Graph);
 void  insertEdge(Graph, Edge);
 void  removeEdge(Graph, Edge);
 int   adjacent(Graph, Vertex, Vertex);  // returns weight, or 0 if not adjacent
+int   edgeWeight(Graph, Vertex, Vertex);// returns weight (may be 0), or NO_EDGE
+int   degree(Graph, Vertex);            // #out-neighbours of a vertex
+Vertex firstNeighbour(Graph, Vertex);   // lowest out-neighbour, or -1 if none
+Vertex nextNeighbour(Graph, Vertex, Vertex);  // next out-neighbour after w, or -1
+void  setDensityThreshold(Graph, double);     // use a matrix once E/V^2 exceeds this
+GraphStats graphStats(Graph);
 void  showGraph(Graph);
-void  freeGraph(Graph);
\ No newline at end of file
+void  freeGraph(Graph);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,282 @@
+// Weighted Directed Graph ADT
+// Compressed Sparse Row Representation ... COMP9024 25T1
+//
+// Out-edges of vertex v are targets[offsets[v] .. offsets[v+1]-1], ascending,
+// with their weights at the same indices in weights[]; absence is explicit
+// (NO_EDGE), so any int but NO_EDGE is a valid weight, 0 included.
+//
+// insertEdge and removeEdge only log the change.  The log is applied in one
+// pass the next time the graph is read: it is bucketed by source vertex with a
+// counting sort, each bucket is sorted by target and log order, and every row
+// is merged with its updates into fresh arrays.  A batch of P changes costs
+// O(V + E + P log P), so updates should come in bulk between queries.
+#include "WGraph.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+typedef struct Update {
+   Vertex v, w;
+   int    weight;    // NO_EDGE for a removal
+   long   seq;       // position in the log
+} Update;
+
+typedef struct GraphRep {
+   long   *offsets;  // nV+1 row starts into targets[] and weights[]
+   Vertex *targets;  // ascending within each row
+   int    *weights;
+   Update *log;      // changes not yet applied, in call order
+   long    nLog;
+   long    capLog;
+   int     nV;       // #vertices
+   long    nE;       // #edges, once the log is applied
+} GraphRep;
+
+static int byTargetThenSeq(const void *a, const void *b) {
+   const Update *x = a, *y = b;
+   if (x->w != y->w)
+      return (x->w > y->w) - (x->w < y->w);
+   return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+// apply the logged changes in call order
+static void flush(Graph g) {
+   if (g->nLog == 0)
+      return;
+   int nV = g->nV;
+
+   // bucket the log by source vertex, keeping call order within each bucket
+   long *start = calloc(nV + 1, sizeof(long));
+   Update *sorted = malloc(g->nLog * sizeof(Update));
+   assert(start != NULL && sorted != NULL);
+   long nInserts = 0;
+   for (long i = 0; i < g->nLog; i++) {
+      start[g->log[i].v + 1]++;
+      nInserts += g->log[i].weight != NO_EDGE;
+   }
+   for (Vertex v = 0; v < nV; v++)
+      start[v + 1] += start[v];
+   for (long i = 0; i < g->nLog; i++) {
+      Update u = g->log[i];
+      u.seq = i;
+      sorted[start[u.v]++] = u;
+   }
+   for (Vertex v = nV; v > 0; v--)          // start[v] was advanced to start[v+1]
+      start[v] = start[v - 1];
+   start[0] = 0;
+
+   long cap = g->nE + nInserts;
+   long *offsets = malloc((nV + 1) * sizeof(long));
+   Vertex *targets = malloc((cap > 0 ? cap : 1) * sizeof(Vertex));
+   int *weights = malloc((cap > 0 ? cap : 1) * sizeof(int));
+   assert(offsets != NULL && targets != NULL && weights != NULL);
+
+   // merge each row with its updates; for one target the first insert into
+   // an absent edge wins and a removal clears it
+   long n = 0;
+   for (Vertex v = 0; v < nV; v++) {
+      offsets[v] = n;
+      Update *up = sorted + start[v];
+      long nUp = start[v + 1] - start[v];
+      if (nUp > 1)
+         qsort(up, nUp, sizeof(Update), byTargetThenSeq);
+      long i = g->offsets[v], end = g->offsets[v + 1], j = 0;
+      while (i < end || j < nUp) {
+         if (j == nUp || (i < end && g->targets[i] < up[j].w)) {
+            targets[n] = g->targets[i];
+            weights[n++] = g->weights[i++];
+            continue;
+         }
+         Vertex w = up[j].w;
+         int weight = NO_EDGE;
+         if (i < end && g->targets[i] == w)
+            weight = g->weights[i++];
+         for (; j < nUp && up[j].w == w; j++) {
+            if (up[j].weight == NO_EDGE)
+               weight = NO_EDGE;
+            else if (weight == NO_EDGE)
+               weight = up[j].weight;
+         }
+         if (weight != NO_EDGE) {
+            targets[n] = w;
+            weights[n++] = weight;
+         }
+      }
+   }
+   offsets[nV] = n;
+
+   free(g->offsets);
+   free(g->targets);
+   free(g->weights);
+   g->offsets = offsets;
+   g->targets = realloc(targets, (n > 0 ? n : 1) * sizeof(Vertex));
+   g->weights = realloc(weights, (n > 0 ? n : 1) * sizeof(int));
+   assert(g->targets != NULL && g->weights != NULL);
+   g->nE = n;
+   free(g->log);                             // most batches come once, so give it back
+   g->log = NULL;
+   g->nLog = g->capLog = 0;
+   free(start);
+   free(sorted);
+}
+
+static void logUpdate(Graph g, Vertex v, Vertex w, int weight) {
+   if (g->nLog == g->capLog) {
+      g->capLog = g->capLog > 0 ? 2 * g->capLog : 64;
+      g->log = realloc(g->log, g->capLog * sizeof(Update));
+      assert(g->log != NULL);
+   }
+   g->log[g->nLog++] = (Update){ v, w, weight, 0 };
+}
+
+// index of edge v-w in targets[], or -1
+static long find(Graph g, Vertex v, Vertex w) {
+   flush(g);
+   long lo = g->offsets[v], hi = g->offsets[v + 1];
+   while (lo < hi) {
+      long mid = lo + (hi - lo) / 2;
+      if (g->targets[mid] < w)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo < g->offsets[v + 1] && g->targets[lo] == w ? lo : -1;
+}
+
+Graph newGraph(int V) {
+   return newGraphSized(V, 0);
+}
+
+// reserve log space for about nE insertions
+Graph newGraphSized(int V, long nE) {
+   assert(V >= 0 && nE >= 0);
+
+   Graph g = malloc(sizeof(GraphRep));
+   assert(g != NULL);
+   g->nV = V;
+   g->nE = 0;
+   g->offsets = calloc(V + 1, sizeof(long));
+   g->targets = malloc(sizeof(Vertex));
+   g->weights = malloc(sizeof(int));
+   g->capLog = nE;
+   g->nLog = 0;
+   g->log = malloc((nE > 0 ? nE : 1) * sizeof(Update));
+   assert(g->offsets != NULL && g->targets != NULL && g->weights != NULL && g->log != NULL);
+
+   return g;
+}
+
+// a repeated pair keeps its first weight, as with insertEdge
+Graph newGraphFromEdges(int V, const Edge *edges, long nE) {
+   assert(nE >= 0 && (edges != NULL || nE == 0));
+
+   Graph g = newGraphSized(V, nE);
+   for (long i = 0; i < nE; i++)
+      insertEdge(g, edges[i]);
+   flush(g);
+   return g;
+}
+
+int numOfVertices(Graph g) {
+   return g->nV;
+}
+
+// check if vertex is valid in a graph
+int validV(Graph g, Vertex v) {
+   return (g != NULL && v >= 0 && v < g->nV);
+}
+
+// no effect if the edge is already in the graph
+void insertEdge(Graph g, Edge e) {
+   assert(g != NULL && validV(g,e.v) && validV(g,e.w) && e.weight != NO_EDGE);
+
+   logUpdate(g, e.v, e.w, e.weight);
+}
+
+void removeEdge(Graph g, Edge e) {
+   assert(g != NULL && validV(g,e.v) && validV(g,e.w));
+
+   logUpdate(g, e.v, e.w, NO_EDGE);
+}
+
+int adjacent(Graph g, Vertex v, Vertex w) {
+   assert(g != NULL && validV(g,v) && validV(g,w));
+
+   long i = find(g, v, w);
+   return i >= 0 ? g->weights[i] : 0;
+}
+
+int edgeWeight(Graph g, Vertex v, Vertex w) {
+   assert(g != NULL && validV(g,v) && validV(g,w));
+
+   long i = find(g, v, w);
+   return i >= 0 ? g->weights[i] : NO_EDGE;
+}
+
+int degree(Graph g, Vertex v) {
+   assert(g != NULL && validV(g,v));
+
+   flush(g);
+   return g->offsets[v + 1] - g->offsets[v];
+}
+
+Vertex firstNeighbour(Graph g, Vertex v) {
+   return nextNeighbour(g, v, -1);
+}
+
+// binary search row v for the first target after w
+Vertex nextNeighbour(Graph g, Vertex v, Vertex w) {
+   assert(g != NULL && validV(g,v) && w >= -1 && w < g->nV);
+
+   flush(g);
+   long lo = g->offsets[v], hi = g->offsets[v + 1];
+   while (lo < hi) {
+      long mid = lo + (hi - lo) / 2;
+      if (g->targets[mid] <= w)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo < g->offsets[v + 1] ? g->targets[lo] : -1;
+}
+
+// rows are always compressed, so there is nothing to switch
+void setDensityThreshold(Graph g, double density) {
+   assert(g != NULL && density > 0);
+}
+
+GraphStats graphStats(Graph g) {
+   assert(g != NULL);
+
+   flush(g);
+   GraphStats s;
+   s.dense = false;
+   s.nV = g->nV;
+   s.nE = g->nE;
+   s.bytes = sizeof(GraphRep) + (g->nV + 1) * sizeof(long)
+           + g->nE * (sizeof(Vertex) + sizeof(int)) + g->capLog * sizeof(Update);
+   return s;
+}
+
+void showGraph(Graph g) {
+    assert(g != NULL);
+    int i;
+    long j;
+
+    flush(g);
+    printf("Number of vertices: %d\n", g->nV);
+    printf("Number of edges: %ld\n", g->nE);
+    for (i = 0; i < g->nV; i++)
+       for (j = g->offsets[i]; j < g->offsets[i + 1]; j++)
+	  printf("Edge %d - %d: %d\n", i, g->targets[j], g->weights[j]);
+}
+
+void freeGraph(Graph g) {
+   assert(g != NULL);
+
+   free(g->offsets);
+   free(g->targets);
+   free(g->weights);
+   free(g->log);
+   free(g);
+}
\ No newline at end of file
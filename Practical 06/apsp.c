@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "APSP.h"
+
+// all-pairs distances of an undirected weighted graph entered like for dijkstra
+int main(int argc, char *argv[])
+{
+    const char *outFile = NULL;
+    ApspMethod method = APSP_AUTO;
+    int threads = 0;
+    for (int a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "-o") == 0 && a + 1 < argc)
+        {
+            outFile = argv[++a];
+        }
+        else if (strcmp(argv[a], "-m") == 0 && a + 1 < argc && strcmp(argv[a + 1], "floyd") == 0)
+        {
+            method = APSP_FLOYD;
+            a++;
+        }
+        else if (strcmp(argv[a], "-m") == 0 && a + 1 < argc && strcmp(argv[a + 1], "dijkstra") == 0)
+        {
+            method = APSP_DIJKSTRA;
+            a++;
+        }
+        else if (strcmp(argv[a], "-t") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0)
+        {
+            threads = atoi(argv[++a]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-o file] [-m floyd|dijkstra] [-t threads]\n", argv[0]);
+            fprintf(stderr, "  -o  write the distance matrix to a binary file instead of printing it\n");
+            fprintf(stderr, "  -m  method (default: dijkstra for sparse graphs, floyd otherwise)\n");
+            fprintf(stderr, "  -t  number of worker threads (default: all CPUs)\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    Edge e;
+    int n;
+    printf("Enter the number of vertices: ");
+    if (scanf("%d", &n) != 1 || n < 1)
+    {
+        fprintf(stderr, "Invalid number of vertices.\n");
+        return EXIT_FAILURE;
+    }
+    Graph g = newGraph(n);
+
+    printf("Enter an edge (from): ");
+    while (scanf("%d", &e.v) == 1)
+    {
+        printf("Enter an edge (to): ");
+        if (scanf("%d", &e.w) != 1)
+            break;
+        printf("Enter the weight: ");
+        if (scanf("%d", &e.weight) != 1)
+            break;
+        // weight 0 is no edge, as for dijkstra
+        if (e.v >= 0 && e.v < n && e.w >= 0 && e.w < n && e.weight != 0 && e.weight != NO_EDGE)
+        {
+            insertEdge(g, e);
+            Vertex t = e.v; // add the edge in both directions
+            e.v = e.w;
+            e.w = t;
+            insertEdge(g, e);
+        }
+        printf("Enter an edge (from): ");
+    }
+    printf("Done.\n");
+
+    WCSR *csr = newWCSR(g);
+    freeGraph(g);
+    DistMatrix m;
+    if (!newDistMatrix(n, outFile, &m))
+    {
+        freeWCSR(csr);
+        return EXIT_FAILURE;
+    }
+    method = allPairs(csr, method, threads, m.d);
+    freeWCSR(csr);
+
+    if (outFile != NULL)
+    {
+        printf("Wrote %d x %d distances to %s (%s).\n", n, n, outFile,
+               method == APSP_FLOYD ? "Floyd-Warshall" : "Dijkstra");
+    }
+    else
+    {
+        for (int u = 0; u < n; u++)
+        {
+            printf("%d:", u);
+            for (int v = 0; v < n; v++)
+            {
+                int32_t d = m.d[(size_t)u * n + v];
+                if (d == APSP_NO_PATH)
+                    printf(" -");
+                else
+                    printf(" %d", d);
+            }
+            printf("\n");
+        }
+    }
+    freeDistMatrix(&m);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "Betweenness.h"
+
+// betweenness centrality of an undirected weighted graph entered like for dijkstra
+int main(int argc, char *argv[])
+{
+    int top = 0, samples = 0, threads = 0;
+    for (int a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "-k") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0)
+        {
+            top = atoi(argv[++a]);
+        }
+        else if (strcmp(argv[a], "-a") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0)
+        {
+            samples = atoi(argv[++a]);
+        }
+        else if (strcmp(argv[a], "-t") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0)
+        {
+            threads = atoi(argv[++a]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-k top] [-a samples] [-t threads]\n", argv[0]);
+            fprintf(stderr, "  -k  print only this many vertices of highest centrality (default: all)\n");
+            fprintf(stderr, "  -a  estimate from this many sampled source vertices\n");
+            fprintf(stderr, "  -t  number of worker threads (default: all CPUs)\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    Edge e;
+    int n;
+    printf("Enter the number of vertices: ");
+    if (scanf("%d", &n) != 1 || n < 1)
+    {
+        fprintf(stderr, "Invalid number of vertices.\n");
+        return EXIT_FAILURE;
+    }
+    Graph g = newGraph(n);
+
+    printf("Enter an edge (from): ");
+    while (scanf("%d", &e.v) == 1)
+    {
+        printf("Enter an edge (to): ");
+        if (scanf("%d", &e.w) != 1)
+            break;
+        printf("Enter the weight: ");
+        if (scanf("%d", &e.weight) != 1)
+            break;
+        // weight 0 is no edge, as for dijkstra
+        if (e.v >= 0 && e.v < n && e.w >= 0 && e.w < n && e.weight != 0 && e.weight != NO_EDGE)
+        {
+            insertEdge(g, e);
+            Vertex t = e.v; // add the edge in both directions
+            e.v = e.w;
+            e.w = t;
+            insertEdge(g, e);
+        }
+        printf("Enter an edge (from): ");
+    }
+    printf("Done.\n");
+
+    WCSR *csr = newWCSR(g);
+    freeGraph(g);
+    double *bc = malloc(n * sizeof(double));
+    Vertex *best = malloc(n * sizeof(Vertex));
+    if (bc == NULL || best == NULL)
+    {
+        fprintf(stderr, "Memory allocation error.\n");
+        freeWCSR(csr);
+        free(bc);
+        free(best);
+        return EXIT_FAILURE;
+    }
+    betweenness(csr, samples, 1, threads, bc);
+    freeWCSR(csr);
+
+    int shown = topBetweenness(bc, n, top > 0 ? top : n, best);
+    if (samples > 0 && samples < n)
+        printf("Betweenness (estimated from %d sources):\n", samples);
+    else
+        printf("Betweenness:\n");
+    for (int i = 0; i < shown; i++)
+    {
+        printf("%d: %.3f\n", best[i], bc[best[i]] / 2); // each pair was counted from both ends
+    }
+    free(bc);
+    free(best);
+    return EXIT_SUCCESS;
+}
@@ -1,32 +1,47 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include "PQueue.h"
+#include "SSSP.h"
+#include "DynSSSP.h"
 
 #define VERY_HIGH_VALUE 999999
-#define MAX_NODES 1000
 
 void printPath(int pred[], int v)
 {
-    int path[MAX_NODES];
     int len = 0;
-    while (v != -1)
+    for (int u = v; u != -1; u = pred[u])
+        len++;
+    int *path = malloc(len * sizeof(int));
+    if (path == NULL)
     {
-        path[len++] = v;
-        v = pred[v];
+        fprintf(stderr, "Memory allocation error.\n");
+        exit(EXIT_FAILURE);
     }
-    for (int i = len - 1; i >= 0; i--)
+    for (int i = len - 1; i >= 0; i--, v = pred[v])
     {
-        printf(i == len - 1 ? "%d" : "-%d", path[i]);
+        path[i] = v;
     }
+    for (int i = 0; i < len; i++)
+    {
+        printf(i == 0 ? "%d" : "-%d", path[i]);
+    }
+    free(path);
 }
 
 void dijkstraSSSP(Graph g, Vertex source)
 {
-    int dist[MAX_NODES];
-    int pred[MAX_NODES];
-    bool vSet[MAX_NODES];
     int nV = numOfVertices(g);
+    int *dist = malloc(nV * sizeof(int));
+    int *pred = malloc(nV * sizeof(int));
+    bool *vSet = malloc(nV * sizeof(bool));
+    PQueue q = newPQueue(nV);
+    if (dist == NULL || pred == NULL || vSet == NULL)
+    {
+        fprintf(stderr, "Memory allocation error.\n");
+        exit(EXIT_FAILURE);
+    }
 
     for (int i = 0; i < nV; i++)
     {
@@ -36,17 +51,14 @@ void dijkstraSSSP(Graph g, Vertex source)
     }
 
     dist[source] = 0;
-    PQueueInit();
-    joinPQueue(source);
+    pqJoin(q, source, 0);
 
-    while (!PQueueIsEmpty())
+    while (!pqIsEmpty(q))
     {
-        int u = leavePQueue(dist);
-        if (!vSet[u])
-            continue;
+        int u = pqLeave(q);
         vSet[u] = false;
 
-        for (int v = 0; v < nV; v++)
+        for (int v = firstNeighbour(g, u); v != -1; v = nextNeighbour(g, u, v))
         {
             int w = adjacent(g, u, v);
             if (w > 0 && vSet[v])
@@ -56,7 +68,10 @@ void dijkstraSSSP(Graph g, Vertex source)
                 {
                     dist[v] = alt;
                     pred[v] = u;
-                    joinPQueue(v);
+                    if (pqContains(q, v))
+                        decreaseKey(q, v, alt);
+                    else
+                        pqJoin(q, v, alt);
                 }
             }
         }
@@ -75,6 +90,43 @@ void dijkstraSSSP(Graph g, Vertex source)
             printf("\n");
         }
     }
+    dropPQueue(q);
+    free(dist);
+    free(pred);
+    free(vSet);
+}
+
+// same result as dijkstraSSSP, by parallel delta-stepping over a CSR view
+void deltaSSSP(Graph g, Vertex source, long delta, int nThreads)
+{
+    int nV = numOfVertices(g);
+    long *dist = malloc(nV * sizeof(long));
+    int *pred = malloc(nV * sizeof(int));
+    if (dist == NULL || pred == NULL)
+    {
+        fprintf(stderr, "Memory allocation error.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    WCSR *csr = newWCSR(g);
+    deltaStepping(csr, source, delta, nThreads, dist, pred);
+    freeWCSR(csr);
+
+    for (int v = 0; v < nV; v++)
+    {
+        if (dist[v] < 0)
+        {
+            printf("%d: no path\n", v);
+        }
+        else
+        {
+            printf("%d: distance = %ld, shortest path: ", v, dist[v]);
+            printPath(pred, v);
+            printf("\n");
+        }
+    }
+    free(dist);
+    free(pred);
 }
 
 void reverseEdge(Edge *e)
@@ -84,10 +136,103 @@ void reverseEdge(Edge *e)
     e->w = temp;
 }
 
-int main(void)
+void printDynamic(DynSSSP *d)
+{
+    for (int v = 0; v < d->nV; v++)
+    {
+        if (d->dist[v] == DYN_NO_PATH)
+        {
+            printf("%d: no path\n", v);
+        }
+        else
+        {
+            printf("%d: distance = %d, shortest path: ", v, d->dist[v]);
+            printPath(d->pred, v);
+            printf("\n");
+        }
+    }
+}
+
+// same result as dijkstraSSSP, then kept up to date under edge updates read
+// after the graph: each changes the edge in both directions, weight 0 removes it
+void dynamicSSSP(Graph g, Vertex source)
+{
+    Edge e;
+    int n = numOfVertices(g);
+    DynSSSP *d = newDynSSSP(g, source);
+    printDynamic(d);
+
+    scanf("%*s"); // the token that ended the edges
+    printf("Enter an update (from): ");
+    while (scanf("%d", &e.v) == 1)
+    {
+        printf("Enter an update (to): ");
+        if (scanf("%d", &e.w) != 1)
+            break;
+        printf("Enter the new weight (0 removes the edge): ");
+        if (scanf("%d", &e.weight) != 1)
+            break;
+        if (e.v >= 0 && e.v < n && e.w >= 0 && e.w < n && e.weight != NO_EDGE)
+        {
+            int updated;
+            if (e.weight == 0)
+            {
+                updated = dynRemoveEdge(d, e.v, e.w) + dynRemoveEdge(d, e.w, e.v);
+            }
+            else
+            {
+                updated = dynSetEdge(d, e);
+                reverseEdge(&e);
+                updated += dynSetEdge(d, e);
+            }
+            printf("%d vertex updates\n", updated);
+        }
+        printf("Enter an update (from): ");
+    }
+    printf("Done.\n");
+    printDynamic(d);
+    freeDynSSSP(d);
+}
+
+int main(int argc, char *argv[])
 {
     Edge e;
     int n, source;
+    bool parallel = false;
+    bool dynamic = false;
+    long delta = 0;
+    int threads = 0;
+    for (int a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "-d") == 0 && a + 1 < argc && atol(argv[a + 1]) > 0)
+        {
+            delta = atol(argv[++a]);
+            parallel = true;
+        }
+        else if (strcmp(argv[a], "-t") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0)
+        {
+            threads = atoi(argv[++a]);
+            parallel = true;
+        }
+        else if (strcmp(argv[a], "-u") == 0)
+        {
+            dynamic = true;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-d delta] [-t threads] | [-u]\n", argv[0]);
+            fprintf(stderr, "  either of -d, -t runs parallel delta-stepping instead of Dijkstra\n");
+            fprintf(stderr, "  -d  bucket width (default: from edge weights and degrees)\n");
+            fprintf(stderr, "  -t  number of worker threads (default: all CPUs)\n");
+            fprintf(stderr, "  -u  then read edge updates and repair the paths after each\n");
+            return EXIT_FAILURE;
+        }
+    }
+    if (parallel && dynamic)
+    {
+        fprintf(stderr, "%s: -u cannot be combined with -d or -t\n", argv[0]);
+        return EXIT_FAILURE;
+    }
 
     printf("Enter the number of vertices: ");
     scanf("%d", &n);
@@ -102,14 +247,23 @@ int main(void)
         scanf("%d", &e.w);
         printf("Enter the weight: ");
         scanf("%d", &e.weight);
-        insertEdge(g, e);
-        reverseEdge(&e); // ensure to add edge in both directions
-        insertEdge(g, e);
+        // 0 is read as no edge, as when the matrix held 0 for an absent edge
+        if (e.weight != 0 && e.weight != NO_EDGE)
+        {
+            insertEdge(g, e);
+            reverseEdge(&e); // ensure to add edge in both directions
+            insertEdge(g, e);
+        }
         printf("Enter an edge (from): ");
     }
     printf("Done.\n");
 
-    dijkstraSSSP(g, source);
+    if (dynamic)
+        dynamicSSSP(g, source);
+    else if (parallel)
+        deltaSSSP(g, source, delta, threads);
+    else
+        dijkstraSSSP(g, source);
     freeGraph(g);
     return 0;
 }
\ No newline at end of file
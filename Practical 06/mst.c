@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "MST.h"
+
+// minimum spanning forest of an undirected weighted graph entered like for dijkstra
+int main(int argc, char *argv[])
+{
+    MstMethod method = MST_AUTO;
+    int threads = 0;
+    for (int a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "-m") == 0 && a + 1 < argc && strcmp(argv[a + 1], "kruskal") == 0)
+        {
+            method = MST_KRUSKAL;
+            a++;
+        }
+        else if (strcmp(argv[a], "-m") == 0 && a + 1 < argc && strcmp(argv[a + 1], "prim") == 0)
+        {
+            method = MST_PRIM;
+            a++;
+        }
+        else if (strcmp(argv[a], "-m") == 0 && a + 1 < argc && strcmp(argv[a + 1], "boruvka") == 0)
+        {
+            method = MST_BORUVKA;
+            a++;
+        }
+        else if (strcmp(argv[a], "-t") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0)
+        {
+            threads = atoi(argv[++a]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-m kruskal|prim|boruvka] [-t threads]\n", argv[0]);
+            fprintf(stderr, "  -m  method (default: boruvka with threads to spare, else prim for dense\n");
+            fprintf(stderr, "      graphs and kruskal for sparse ones)\n");
+            fprintf(stderr, "  -t  number of worker threads (default: all CPUs)\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    Edge e;
+    int n;
+    printf("Enter the number of vertices: ");
+    if (scanf("%d", &n) != 1 || n < 1)
+    {
+        fprintf(stderr, "Invalid number of vertices.\n");
+        return EXIT_FAILURE;
+    }
+    Graph g = newGraph(n);
+
+    printf("Enter an edge (from): ");
+    while (scanf("%d", &e.v) == 1)
+    {
+        printf("Enter an edge (to): ");
+        if (scanf("%d", &e.w) != 1)
+            break;
+        printf("Enter the weight: ");
+        if (scanf("%d", &e.weight) != 1)
+            break;
+        // weight 0 is no edge, as for dijkstra
+        if (e.v >= 0 && e.v < n && e.w >= 0 && e.w < n && e.weight != 0 && e.weight != NO_EDGE)
+        {
+            insertEdge(g, e);
+            Vertex t = e.v; // add the edge in both directions
+            e.v = e.w;
+            e.w = t;
+            insertEdge(g, e);
+        }
+        printf("Enter an edge (from): ");
+    }
+    printf("Done.\n");
+
+    WCSR *csr = newWCSR(g);
+    freeGraph(g);
+    Edge *tree = malloc(n * sizeof(Edge));
+    if (tree == NULL)
+    {
+        fprintf(stderr, "Memory allocation error.\n");
+        freeWCSR(csr);
+        return EXIT_FAILURE;
+    }
+    int nTree;
+    long total;
+    method = spanningForest(csr, method, threads, tree, &nTree, &total);
+    freeWCSR(csr);
+
+    static const char *Names[] = {"auto", "Kruskal", "Prim", "Boruvka"};
+    printf("Minimum spanning %s (%s):\n", nTree == n - 1 ? "tree" : "forest", Names[method]);
+    for (int i = 0; i < nTree; i++)
+    {
+        printf("%d - %d: %d\n", tree[i].v, tree[i].w, tree[i].weight);
+    }
+    printf("Total weight: %ld\n", total);
+    free(tree);
+    return EXIT_SUCCESS;
+}
@@ -1,60 +1,332 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include "WGraph.h"
+#include <stdbool.h>
+#include <string.h>
+#include "EdgeStream.h"
+#include "PageRank.h"
+#include "Parallel.h"
+#include "Sort.h"
 
-int main(void)
+#define HISTOGRAM_BUDGET (1L << 28) /* 各线程私有直方图合计最多占用的字节数 */
+
+/* 度数统计：线程 0 直接写入 indegree/outdegree，其余线程各有一份私有直方图 */
+typedef struct
 {
     int V;
-    printf("Enter the number of vertices: ");
-    if (scanf("%d", &V) != 1 || V <= 0)
+    int nThreads;
+    int *indegree, *outdegree;
+    int **in, **out; /* in[t], out[t]：线程 t 的直方图；NULL 表示共享计数 */
+} Counts;
+
+/* 把一块边计入当前线程的直方图；内存不够时改用原子操作计入共享数组 */
+static void countBlock(const Edge *edges, long n, int thread, void *arg)
+{
+    Counts *c = arg;
+    if (c->in != NULL)
     {
-        return EXIT_FAILURE;
+        int *in = c->in[thread], *out = c->out[thread];
+        for (long i = 0; i < n; i++)
+        {
+            out[edges[i].v]++;
+            in[edges[i].w]++;
+        }
+    }
+    else
+    {
+        for (long i = 0; i < n; i++)
+        {
+            __atomic_fetch_add(&c->outdegree[edges[i].v], 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&c->indegree[edges[i].w], 1, __ATOMIC_RELAXED);
+        }
     }
+}
 
-    Graph g = newGraph(V);
-    if (!g)
+/* 按顶点区间并行合并各线程的直方图 */
+static void mergeRange(int lo, int hi, int thread, void *arg)
+{
+    Counts *c = arg;
+    for (int t = 1; t < c->nThreads; t++)
     {
-        return EXIT_FAILURE;
+        for (int v = lo; v < hi; v++)
+        {
+            c->indegree[v] += c->in[t][v];
+            c->outdegree[v] += c->out[t][v];
+        }
     }
+}
 
-    int *indegree = NULL, *outdegree = NULL, *vertices = NULL;
-    double *popularity = NULL;
+/* 不建图，直接从边流统计出入度 */
+static bool countStream(const char *path, int threads, int *V, int **indegree, int **outdegree)
+{
+    EdgeStream s;
+    if (!openEdgeStream(path, threads, &s))
+        return false;
+    Counts c = {s.nV, s.nThreads, calloc(s.nV, sizeof(int)), calloc(s.nV, sizeof(int)), NULL, NULL};
+    if (!c.indegree || !c.outdegree)
+    {
+        fprintf(stderr, "Memory allocation error.\n");
+        exit(EXIT_FAILURE);
+    }
+    if ((long)c.nThreads * c.V * 2 * sizeof(int) <= HISTOGRAM_BUDGET)
+    {
+        c.in = malloc(c.nThreads * sizeof(int *));
+        c.out = malloc(c.nThreads * sizeof(int *));
+        if (!c.in || !c.out)
+        {
+            fprintf(stderr, "Memory allocation error.\n");
+            exit(EXIT_FAILURE);
+        }
+        c.in[0] = c.indegree;
+        c.out[0] = c.outdegree;
+        for (int t = 1; t < c.nThreads; t++)
+        {
+            c.in[t] = calloc(c.V, sizeof(int));
+            c.out[t] = calloc(c.V, sizeof(int));
+            if (!c.in[t] || !c.out[t])
+            {
+                fprintf(stderr, "Memory allocation error.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
 
-    /* 一次性分配所有需要的内存 */
-    if (!(indegree = calloc(V, sizeof(int))))
-        goto cleanup;
-    if (!(outdegree = calloc(V, sizeof(int))))
-        goto cleanup;
-    if (!(popularity = malloc(V * sizeof(double))))
-        goto cleanup;
-    if (!(vertices = malloc(V * sizeof(int))))
-        goto cleanup;
+    bool ok = streamEdges(&s, countBlock, &c);
+    if (c.in != NULL)
+    {
+        parallelFor(c.V, 1 << 16, c.nThreads, mergeRange, &c);
+        for (int t = 1; t < c.nThreads; t++)
+        {
+            free(c.in[t]);
+            free(c.out[t]);
+        }
+        free(c.in);
+        free(c.out);
+    }
+    closeEdgeStream(&s);
+    *V = c.V;
+    *indegree = c.indegree;
+    *outdegree = c.outdegree;
+    return ok;
+}
+
+/* PageRank：两遍读边建立入链 CSR，然后迭代；迭代次数与残差输出到 stderr。
+   结果乘以顶点数，平均每个顶点得 1 分 */
+static bool rankStream(const char *path, int threads, double damping, double tolerance, int maxIter,
+                       int *V, double **popularity)
+{
+    EdgeStream s;
+    if (!openEdgeStream(path, threads, &s))
+        return false;
+    InLinks *g = newInLinks(&s);
+    threads = s.nThreads;
+    closeEdgeStream(&s);
+    if (g == NULL)
+        return false;
+
+    *V = g->nV;
+    if (!(*popularity = malloc(g->nV * sizeof(double))))
+    {
+        freeInLinks(g);
+        return false;
+    }
+    double residual;
+    int iterations = pageRank(g, damping, tolerance, maxIter, threads, *popularity, &residual, stderr);
+    fprintf(stderr, "PageRank: %d iterations, residual %.3e%s\n", iterations, residual,
+            residual < tolerance ? "" : " (not converged)");
+    for (int v = 0; v < g->nV; v++)
+    {
+        (*popularity)[v] *= g->nV;
+    }
+    freeInLinks(g);
+    return true;
+}
+
+/* 排名规则：流行度高者在前，流行度相同时顶点号小者在前 */
+static bool ranksBefore(const double *popularity, int a, int b)
+{
+    return popularity[a] > popularity[b] || (popularity[a] == popularity[b] && a < b);
+}
+
+static int byRank(const void *a, const void *b, void *popularity)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return ranksBefore(popularity, x, y) ? -1 : ranksBefore(popularity, y, x);
+}
+
+/* 全部排名：键为流行度（降序），基数排序后同键的顶点保持升序 */
+static bool rankAll(const double *popularity, int V, int threads, int *vertices)
+{
+    KeyIndex *order = malloc(V * sizeof(KeyIndex));
+    if (!order)
+        return false;
+    for (int v = 0; v < V; v++)
+    {
+        order[v].key = ~doubleKey(popularity[v]);
+        order[v].index = v;
+    }
+    sortKeyIndex(order, V, threads);
+    for (int i = 0; i < V; i++)
+    {
+        vertices[i] = order[i].index;
+    }
+    free(order);
+    return true;
+}
 
-    /* 读取边并更新度数 */
-    int from, to;
-    printf("Enter an edge (from): ");
-    while (scanf("%d", &from) == 1)
+/* 前 k 名：小根堆，堆顶是目前 k 个中排名最靠后的顶点，O(V log k) */
+static int topK(const double *popularity, int V, int k, int *vertices)
+{
+    int n = 0;
+    for (int v = 0; v < V; v++)
+    {
+        int i;
+        if (n < k)
+        {
+            i = n++; /* 上浮 */
+            while (i > 0 && ranksBefore(popularity, vertices[(i - 1) / 2], v))
+            {
+                vertices[i] = vertices[(i - 1) / 2];
+                i = (i - 1) / 2;
+            }
+            vertices[i] = v;
+        }
+        else if (ranksBefore(popularity, v, vertices[0]))
+        {
+            i = 0; /* 替换堆顶后下沉 */
+            for (;;)
+            {
+                int child = 2 * i + 1;
+                if (child >= n)
+                    break;
+                if (child + 1 < n && ranksBefore(popularity, vertices[child], vertices[child + 1]))
+                    child++;
+                if (!ranksBefore(popularity, v, vertices[child]))
+                    break;
+                vertices[i] = vertices[child];
+                i = child;
+            }
+            vertices[i] = v;
+        }
+    }
+    sortGeneric(vertices, n, sizeof(int), byRank, (void *)popularity);
+    return n;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *edgeFile = NULL;
+    int threads = 0, top = 0, maxIter = 100;
+    bool pagerank = false, usage = false;
+    double damping = 0.85, tolerance = 1e-6;
+    for (int a = 1; a < argc; a++)
     {
-        printf("Enter an edge (to): ");
-        if (scanf("%d", &to) != 1)
+        if (strcmp(argv[a], "-f") == 0 && a + 1 < argc)
+        {
+            edgeFile = argv[++a];
+        }
+        else if (strcmp(argv[a], "-k") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0)
+        {
+            top = atoi(argv[++a]);
+        }
+        else if (strcmp(argv[a], "-t") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0)
         {
+            threads = atoi(argv[++a]);
+        }
+        else if (strcmp(argv[a], "-p") == 0)
+        {
+            pagerank = true;
+        }
+        else if (strcmp(argv[a], "-d") == 0 && a + 1 < argc && atof(argv[a + 1]) >= 0 && atof(argv[a + 1]) < 1)
+        {
+            damping = atof(argv[++a]);
+        }
+        else if (strcmp(argv[a], "-e") == 0 && a + 1 < argc && atof(argv[a + 1]) > 0)
+        {
+            tolerance = atof(argv[++a]);
+        }
+        else if (strcmp(argv[a], "-i") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0)
+        {
+            maxIter = atoi(argv[++a]);
+        }
+        else
+        {
+            usage = true;
             break;
         }
-        if (from >= 0 && from < V && to >= 0 && to < V)
+    }
+    if (usage || (pagerank && edgeFile == NULL))
+    {
+        fprintf(stderr, "Usage: %s [-f file] [-k count] [-t threads] [-p [-d damping] [-e tolerance] [-i iterations]]\n", argv[0]);
+        fprintf(stderr, "  -f  stream a binary or text edge file (- for text on stdin), no prompts\n");
+        fprintf(stderr, "  -k  print only the given number of leading vertices\n");
+        fprintf(stderr, "  -t  number of worker threads (default: all CPUs)\n");
+        fprintf(stderr, "  -p  rank by PageRank (needs -f); scores are scaled to average 1\n");
+        fprintf(stderr, "  -d  damping factor (default 0.85)\n");
+        fprintf(stderr, "  -e  stop once the L1 change of the ranks is below this (default 1e-6)\n");
+        fprintf(stderr, "  -i  at most this many iterations (default 100)\n");
+        return EXIT_FAILURE;
+    }
+
+    int V, status = EXIT_FAILURE;
+    int *indegree = NULL, *outdegree = NULL, *vertices = NULL;
+    double *popularity = NULL;
+
+    if (pagerank)
+    {
+        if (!rankStream(edgeFile, threads, damping, tolerance, maxIter, &V, &popularity))
+            goto cleanup;
+    }
+    else if (edgeFile != NULL)
+    {
+        if (!countStream(edgeFile, threads, &V, &indegree, &outdegree))
+            goto cleanup;
+    }
+    else
+    {
+        printf("Enter the number of vertices: ");
+        if (scanf("%d", &V) != 1 || V <= 0)
         {
-            Edge e = {from, to, 1};
-            insertEdge(g, e);
-            outdegree[from]++;
-            indegree[to]++;
+            return EXIT_FAILURE;
         }
+        if (!(indegree = calloc(V, sizeof(int))))
+            goto cleanup;
+        if (!(outdegree = calloc(V, sizeof(int))))
+            goto cleanup;
+
+        /* 读取边并更新度数（只需要度数，不必建图） */
+        int from, to;
         printf("Enter an edge (from): ");
+        while (scanf("%d", &from) == 1)
+        {
+            printf("Enter an edge (to): ");
+            if (scanf("%d", &to) != 1)
+            {
+                break;
+            }
+            if (from >= 0 && from < V && to >= 0 && to < V)
+            {
+                outdegree[from]++;
+                indegree[to]++;
+            }
+            printf("Enter an edge (from): ");
+        }
+        printf("Done.\n");
     }
-    printf("Done.\n");
 
-    /* 计算流行度并初始化顶点数组 */
+    /* 一次性分配其余内存 */
+    if (!popularity && !(popularity = malloc(V * sizeof(double))))
+        goto cleanup;
+    if (!(vertices = malloc(V * sizeof(int))))
+        goto cleanup;
+
+    /* 计算流行度（PageRank 已算好）并初始化顶点数组 */
     for (int v = 0; v < V; v++)
     {
-        if (outdegree[v] == 0)
+        if (pagerank)
+        {
+            /* 已由 rankStream 算好 */
+        }
+        else if (outdegree[v] == 0)
         {
             popularity[v] = indegree[v] / 0.5;
         }
@@ -65,28 +337,24 @@ int main(void)
         vertices[v] = v;
     }
 
-    /* 插入排序：按流行度降序，流行度相同时按顶点号升序 */
-    for (int i = 1; i < V; i++)
+    /* 排序：全部排名用基数排序，只要前 k 名时用大小为 k 的堆 */
+    int shown = V;
+    if (top > 0 && top < V)
     {
-        int key = vertices[i];
-        double key_pop = popularity[key];
-        int j = i - 1;
-        while (j >= 0 &&
-               (popularity[vertices[j]] < key_pop ||
-                (popularity[vertices[j]] == key_pop && vertices[j] > key)))
-        {
-            vertices[j + 1] = vertices[j];
-            j--;
-        }
-        vertices[j + 1] = key;
+        shown = topK(popularity, V, top, vertices);
+    }
+    else if (!rankAll(popularity, V, threads, vertices))
+    {
+        goto cleanup;
     }
 
     /* 输出结果 */
-    printf("\nPopularity ranking:\n");
-    for (int i = 0; i < V; i++)
+    printf(edgeFile != NULL ? "Popularity ranking:\n" : "\nPopularity ranking:\n");
+    for (int i = 0; i < shown; i++)
     {
-        printf("%d %.1f\n", vertices[i], popularity[vertices[i]]);
+        printf("%d %.*f\n", vertices[i], pagerank ? 4 : 1, popularity[vertices[i]]);
     }
+    status = EXIT_SUCCESS;
 
 cleanup:
     /* 统一释放资源 */
@@ -94,8 +362,6 @@ cleanup:
     free(outdegree);
     free(popularity);
     free(vertices);
-    if (g)
-        freeGraph(g);
 
-    return EXIT_SUCCESS;
+    return status;
 }
\ No newline at end of file
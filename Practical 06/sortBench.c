@@ -0,0 +1,268 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "Sort.h"
+
+#define INSERTION_MAX (1 << 15) // larger inputs take insertionSort too long
+#define MIN_WORK (1 << 22)      // sort at least this many elements per measurement
+
+// insertionSort from inssort.c, the baseline
+static void insertionSort(int array[], int n)
+{
+    for (int i = 1; i < n; i++)
+    {
+        int element = array[i];
+        int j = i - 1;
+        while (j >= 0 && array[j] > element)
+        {
+            array[j + 1] = array[j];
+            j--;
+        }
+        array[j + 1] = element;
+    }
+}
+
+static int compareInts(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int compareKeyIndex(const void *a, const void *b)
+{
+    const KeyIndex *x = a, *y = b;
+    if (x->key != y->key)
+        return x->key < y->key ? -1 : 1;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+static int compareKeyIndexCtx(const void *a, const void *b, void *ctx)
+{
+    return compareKeyIndex(a, b);
+}
+
+static double now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* ---------- inputs ---------- */
+
+static const char *Patterns[] = {"random", "sorted", "reversed", "few-unique", "organ-pipe", "nearly-sorted"};
+#define N_PATTERNS (int)(sizeof(Patterns) / sizeof(Patterns[0]))
+
+static void fill(int *a, long n, int pattern)
+{
+    for (long i = 0; i < n; i++)
+    {
+        switch (pattern)
+        {
+        case 0: a[i] = rand() - RAND_MAX / 2; break;
+        case 1: a[i] = i; break;
+        case 2: a[i] = n - i; break;
+        case 3: a[i] = rand() % 16; break;
+        case 4: a[i] = i < n / 2 ? i : n - i; break;
+        default: a[i] = i; break;
+        }
+    }
+    if (pattern == 5) // 1% of the elements swapped at random
+    {
+        for (long k = 0; k < n / 100 + 1; k++)
+        {
+            long i = rand() % n, j = rand() % n;
+            int t = a[i];
+            a[i] = a[j];
+            a[j] = t;
+        }
+    }
+}
+
+/* ---------- int sorts ---------- */
+
+static const char *IntSorts[] = {"insertion", "qsort", "pdqsort", "radix", "merge", "sortInts"};
+#define N_INT_SORTS (int)(sizeof(IntSorts) / sizeof(IntSorts[0]))
+
+static void runIntSort(int which, int *a, long n, int threads)
+{
+    switch (which)
+    {
+    case 0: insertionSort(a, n); break;
+    case 1: qsort(a, n, sizeof(int), compareInts); break;
+    case 2: pdqSortInts(a, n); break;
+    case 3: radixSortInts(a, n); break;
+    case 4: mergeSortInts(a, n, threads); break;
+    default: sortInts(a, n, threads); break;
+    }
+}
+
+// ns per element, or -1 if the result is wrong
+static double timeIntSort(int which, const int *input, const int *expect, int *work, long n, int threads)
+{
+    long reps = MIN_WORK / n > 0 ? MIN_WORK / n : 1;
+    double total = 0;
+    for (long r = 0; r < reps; r++)
+    {
+        memcpy(work, input, n * sizeof(int));
+        double start = now();
+        runIntSort(which, work, n, threads);
+        total += now() - start;
+        if (memcmp(work, expect, n * sizeof(int)) != 0)
+            return -1;
+    }
+    return total / reps / n * 1e9;
+}
+
+/* ---------- KeyIndex sorts ---------- */
+
+static const char *PairSorts[] = {"qsort", "sortGeneric", "pdqsort", "radix", "merge", "sortKeyIndex"};
+#define N_PAIR_SORTS (int)(sizeof(PairSorts) / sizeof(PairSorts[0]))
+
+static void runPairSort(int which, KeyIndex *a, long n, int threads)
+{
+    switch (which)
+    {
+    case 0: qsort(a, n, sizeof(KeyIndex), compareKeyIndex); break;
+    case 1: sortGeneric(a, n, sizeof(KeyIndex), compareKeyIndexCtx, NULL); break;
+    case 2: pdqSortKeyIndex(a, n); break;
+    case 3: radixSortKeyIndex(a, n); break;
+    case 4: mergeSortKeyIndex(a, n, threads); break;
+    default: sortKeyIndex(a, n, threads); break;
+    }
+}
+
+static double timePairSort(int which, const KeyIndex *input, const KeyIndex *expect, KeyIndex *work, long n, int threads)
+{
+    long reps = MIN_WORK / n > 0 ? MIN_WORK / n : 1;
+    double total = 0;
+    for (long r = 0; r < reps; r++)
+    {
+        memcpy(work, input, n * sizeof(KeyIndex));
+        double start = now();
+        runPairSort(which, work, n, threads);
+        total += now() - start;
+        for (long i = 0; i < n; i++)
+        {
+            if (work[i].key != expect[i].key || work[i].index != expect[i].index)
+                return -1;
+        }
+    }
+    return total / reps / n * 1e9;
+}
+
+static void printTime(double ns)
+{
+    if (ns < 0)
+        printf(" %12s", "WRONG");
+    else
+        printf(" %12.2f", ns);
+}
+
+// compare the sorts across sizes and input patterns, in ns per element
+int main(int argc, char *argv[])
+{
+    long maxSize = 1 << 20;
+    int threads = 0;
+    for (int a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "-n") == 0 && a + 1 < argc && atol(argv[a + 1]) > 0)
+        {
+            maxSize = atol(argv[++a]);
+        }
+        else if (strcmp(argv[a], "-t") == 0 && a + 1 < argc && atoi(argv[a + 1]) > 0)
+        {
+            threads = atoi(argv[++a]);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-n size] [-t threads]\n", argv[0]);
+            fprintf(stderr, "  -n  largest input (default 1048576); sizes go up from 16 by factors of 16\n");
+            fprintf(stderr, "  -t  threads for the merge sort (default: all CPUs)\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    int *input = malloc(maxSize * sizeof(int));
+    int *expect = malloc(maxSize * sizeof(int));
+    int *work = malloc(maxSize * sizeof(int));
+    KeyIndex *pairs = malloc(maxSize * sizeof(KeyIndex));
+    KeyIndex *pairsExpect = malloc(maxSize * sizeof(KeyIndex));
+    KeyIndex *pairsWork = malloc(maxSize * sizeof(KeyIndex));
+    if (!input || !expect || !work || !pairs || !pairsExpect || !pairsWork)
+    {
+        fprintf(stderr, "Memory allocation error.\n");
+        return EXIT_FAILURE;
+    }
+    bool wrong = false;
+
+    printf("int, ns per element\n%9s %-14s", "size", "pattern");
+    for (int s = 0; s < N_INT_SORTS; s++)
+        printf(" %12s", IntSorts[s]);
+    printf("\n");
+    for (long n = 16; n <= maxSize; n *= 16)
+    {
+        for (int p = 0; p < N_PATTERNS; p++)
+        {
+            srand(n + p);
+            fill(input, n, p);
+            memcpy(expect, input, n * sizeof(int));
+            qsort(expect, n, sizeof(int), compareInts);
+            printf("%9ld %-14s", n, Patterns[p]);
+            for (int s = 0; s < N_INT_SORTS; s++)
+            {
+                if (s == 0 && n > INSERTION_MAX)
+                {
+                    printf(" %12s", "-");
+                    continue;
+                }
+                double ns = timeIntSort(s, input, expect, work, n, threads);
+                wrong |= ns < 0;
+                printTime(ns);
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+
+    // (key, index) pairs as popularityRank sorts them: double keys, distinct indices
+    printf("\nKeyIndex, ns per element\n%9s %-14s", "size", "pattern");
+    for (int s = 0; s < N_PAIR_SORTS; s++)
+        printf(" %12s", PairSorts[s]);
+    printf("\n");
+    for (long n = 16; n <= maxSize; n *= 16)
+    {
+        for (int p = 0; p < N_PATTERNS; p++)
+        {
+            srand(n + p);
+            fill(input, n, p);
+            for (long i = 0; i < n; i++)
+            {
+                pairs[i].key = doubleKey(input[i] / 7.0);
+                pairs[i].index = i;
+            }
+            memcpy(pairsExpect, pairs, n * sizeof(KeyIndex));
+            qsort(pairsExpect, n, sizeof(KeyIndex), compareKeyIndex);
+            printf("%9ld %-14s", n, Patterns[p]);
+            for (int s = 0; s < N_PAIR_SORTS; s++)
+            {
+                double ns = timePairSort(s, pairs, pairsExpect, pairsWork, n, threads);
+                wrong |= ns < 0;
+                printTime(ns);
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+
+    free(input);
+    free(expect);
+    free(work);
+    free(pairs);
+    free(pairsExpect);
+    free(pairsWork);
+    return wrong ? EXIT_FAILURE : EXIT_SUCCESS;
+}
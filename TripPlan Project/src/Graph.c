@@ -1,63 +1,236 @@
 // Graph.c
+
+/*
+A graph starts with an array of (neighbour, walking time) pairs per vertex,
+sorted by neighbour. Once its density 2E/V² rises past the graph's threshold
+it moves to an adjacency matrix, and back once the density falls below a
+quarter of the threshold. A switch costs O(V²+E), and at least a constant
+fraction of threshold·V² edge changes separate two switches, so its cost is
+amortised over them. Failed switches leave the graph as it was.
+*/
+
 #include "Graph.h"
 #include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_THRESHOLD 0.25 // Arrays of pairs with slack cost about this much
+#define HYSTERESIS 4           // Return to arrays below threshold / HYSTERESIS
+
+/**
+ * @struct Link
+ * @brief One neighbour of a vertex
+ */
+typedef struct
+{
+    int to;       // Neighbour index
+    int walkTime; // Walking time in mins
+} Link;
+
+/**
+ * @struct LinkList
+ * @brief Neighbours of a vertex, ascending by index
+ */
+typedef struct
+{
+    Link *links; // Neighbours
+    int n;       // Number of neighbours
+    int cap;     // Allocated length
+} LinkList;
+
+struct GraphRep
+{
+    int nV;           // Number of vertices (landmarks) in graph
+    int nE;           // Number of edges
+    double threshold; // Density at which to switch to the matrix
+    int filling;      // Edges newGraphSized expects; no switch before nE reaches it
+    int *matrix;      // Dense: nV×nV walking times, -1 if not adjacent
+    LinkList *adj;    // Sparse: neighbours of each vertex
+};
+
+/* —————————— Representations —————————— */
+/**
+ * @brief Edge count above which a graph should be dense
+ */
+static double denseAt(Graph G)
+{
+    return G->threshold * G->nV * (double)G->nV / 2;
+}
+
+/**
+ * @brief Binary search for first neighbour with index ≥ v
+ */
+static int search(const LinkList *l, int v)
+{
+    int lo = 0, hi = l->n;
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (l->links[mid].to < v)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Allocate an nV×nV matrix of -1
+ */
+static int *newMatrix(int nV)
+{
+    int *m = malloc((nV > 0 ? (size_t)nV * nV : 1) * sizeof(int));
+    if (m)
+        memset(m, 0xff, (size_t)nV * nV * sizeof(int)); // All bytes 0xff is -1
+    return m;
+}
+
+/**
+ * @brief Move from neighbour arrays to a matrix
+ */
+static void toDense(Graph G)
+{
+    int *m = newMatrix(G->nV);
+    if (!m)
+        return; // Stay sparse
+    for (int u = 0; u < G->nV; u++)
+    {
+        for (int i = 0; i < G->adj[u].n; i++)
+            m[(size_t)u * G->nV + G->adj[u].links[i].to] = G->adj[u].links[i].walkTime;
+        free(G->adj[u].links);
+    }
+    free(G->adj);
+    G->adj = NULL;
+    G->matrix = m;
+}
+
+/**
+ * @brief Move from a matrix to neighbour arrays
+ */
+static void toSparse(Graph G)
+{
+    LinkList *adj = calloc(G->nV, sizeof *adj);
+    if (!adj)
+        return; // Stay dense
+    for (int u = 0; u < G->nV; u++)
+    {
+        const int *row = G->matrix + (size_t)u * G->nV;
+        for (int v = 0; v < G->nV; v++)
+            adj[u].cap += row[v] >= 0;
+        adj[u].links = malloc((adj[u].cap > 0 ? adj[u].cap : 1) * sizeof(Link));
+        if (!adj[u].links)
+        {
+            for (int i = 0; i < u; i++)
+                free(adj[i].links);
+            free(adj);
+            return; // Stay dense
+        }
+        for (int v = 0; v < G->nV; v++)
+            if (row[v] >= 0)
+                adj[u].links[adj[u].n++] = (Link){v, row[v]};
+    }
+    free(G->matrix);
+    G->matrix = NULL;
+    G->adj = adj;
+}
+
+/**
+ * @brief Switch representation if the density has left the current one's range
+ * @note A graph still filling up to its expected size keeps its representation
+ */
+static void rebalance(Graph G)
+{
+    if (G->nE < G->filling)
+        return;
+    G->filling = 0;
+    if (!G->matrix && G->nE > denseAt(G))
+        toDense(G);
+    else if (G->matrix && G->nE < denseAt(G) / HYSTERESIS)
+        toSparse(G);
+}
+
+/**
+ * @brief Ensure room for one more neighbour of u
+ * @return bool false on allocation failure
+ */
+static bool reserve(Graph G, int u)
+{
+    LinkList *l = &G->adj[u];
+    if (l->n < l->cap)
+        return true;
+    int cap = l->cap > 0 ? 2 * l->cap : 4;
+    Link *links = realloc(l->links, cap * sizeof(Link));
+    if (!links)
+        return false;
+    l->links = links;
+    l->cap = cap;
+    return true;
+}
+
+/**
+ * @brief Set, add or (walkTime < 0) remove neighbour v of u in its array
+ */
+static void setLink(Graph G, int u, int v, int walkTime)
+{
+    LinkList *l = &G->adj[u];
+    int i = search(l, v);
+    bool present = i < l->n && l->links[i].to == v;
+    if (present && walkTime >= 0)
+    {
+        l->links[i].walkTime = walkTime;
+    }
+    else if (present)
+    {
+        memmove(l->links + i, l->links + i + 1, (l->n - i - 1) * sizeof(Link));
+        l->n--;
+    }
+    else if (walkTime >= 0)
+    {
+        memmove(l->links + i + 1, l->links + i, (l->n - i) * sizeof(Link));
+        l->links[i] = (Link){v, walkTime};
+        l->n++;
+    }
+}
 
+/* —————————— Graph Functions —————————— */
 /**
  * @brief Allocate and initialize components of a graph
  * @param nV Number of vertices
  * @return Graph Returns graph pointer on success, NULL on failure
  */
 Graph newGraph(int nV)
+{
+    return newGraphSized(nV, 0);
+}
+
+/**
+ * @brief Allocate a graph in the representation suited to nE edges
+ * @param nV Number of vertices
+ * @param nE Expected number of edges
+ * @return Graph Returns graph pointer on success, NULL on failure
+ */
+Graph newGraphSized(int nV, int nE)
 {
     // Allocate graph structure
-    Graph G = malloc(sizeof *G);
+    Graph G = calloc(1, sizeof *G);
     if (!G)
     {
         return NULL;
     }
     G->nV = nV;
-    // Allocate and initialize visited array
-    G->visited = calloc(nV, sizeof(int));
-    if (!G->visited)
+    G->threshold = DEFAULT_THRESHOLD;
+    if (nE > denseAt(G))
     {
-        goto cleanup;
+        G->matrix = newMatrix(nV); // Expected to be dense from the start
+        G->filling = nE;           // Stay so while the first nE edges go in
     }
-    // Allocate and initialize predecessor array
-    G->parent = malloc(nV * sizeof(int));
-    if (!G->parent)
+    else
+        G->adj = calloc(nV > 0 ? nV : 1, sizeof *G->adj);
+    if (!G->matrix && !G->adj)
     {
-        goto cleanup;
-    }
-    for (int i = 0; i < nV; i++)
-    {
-        G->parent[i] = -1; // -1 indicates no predecessor
-    }
-    // Allocate row pointer array for adjacency matrix
-    G->edges = malloc(nV * sizeof(int *));
-    if (!G->edges)
-    {
-        goto cleanup;
-    }
-    // Initialize adjacency matrix
-    for (int i = 0; i < nV; i++)
-    {
-        G->edges[i] = malloc(nV * sizeof(int));
-        if (!G->edges[i])
-        {
-            goto cleanup;
-        }
-        // Initialize all edges as disconnected
-        for (int j = 0; j < nV; j++)
-        {
-            G->edges[i][j] = -1;
-        }
+        free(G);
+        return NULL;
     }
     return G;
-
-cleanup:
-    // Cleanup on allocation failure
-    freeGraph(G);
-    return NULL;
 }
 
 /**
@@ -66,15 +239,107 @@ cleanup:
  * @param u Source vertex index (0 ≤ u < nV)
  * @param v Destination vertex index (0 ≤ v < nV)
  * @param walkTime walkTime New walking time (mins), set to -1 to remove edge
+ * @return bool false on allocation failure, true otherwise
  */
-void insertEdge(Graph G, int u, int v, int walkTime)
+bool insertEdge(Graph G, int u, int v, int walkTime)
 {
     // Check vertex indices
     if (u < 0 || u >= G->nV || v < 0 || v >= G->nV)
+        return true;
+    if (walkTime < 0)
+        walkTime = -1;
+    int old = edgeWeight(G, u, v);
+    if (G->matrix)
+    {
+        // Set edge weight
+        G->matrix[(size_t)u * G->nV + v] = walkTime;
+        G->matrix[(size_t)v * G->nV + u] = walkTime;
+    }
+    else
+    {
+        // Make room in both arrays first so a failure changes nothing
+        if (old < 0 && walkTime >= 0 && (!reserve(G, u) || !reserve(G, v)))
+            return false;
+        setLink(G, u, v, walkTime);
+        if (u != v)
+            setLink(G, v, u, walkTime);
+    }
+    G->nE += (walkTime >= 0) - (old >= 0);
+    rebalance(G);
+    return true;
+}
+
+/**
+ * @brief Walking time between u and v
+ * @param G Graph pointer
+ * @param u Source vertex index (0 ≤ u < nV)
+ * @param v Destination vertex index (0 ≤ v < nV)
+ * @return int Walking time (mins), -1 if not adjacent
+ */
+int edgeWeight(Graph G, int u, int v)
+{
+    if (G->matrix)
+        return G->matrix[(size_t)u * G->nV + v];
+    const LinkList *l = &G->adj[u];
+    int i = search(l, v);
+    return i < l->n && l->links[i].to == v ? l->links[i].walkTime : -1;
+}
+
+/**
+ * @brief Lowest neighbour of u above v
+ * @param G Graph pointer
+ * @param u Vertex index (0 ≤ u < nV)
+ * @param v Previous neighbour, or -1 to start
+ * @return int Neighbour index, -1 if none left
+ */
+int nextNeighbour(Graph G, int u, int v)
+{
+    if (!G->matrix)
+    {
+        const LinkList *l = &G->adj[u];
+        int i = search(l, v + 1);
+        return i < l->n ? l->links[i].to : -1;
+    }
+    const int *row = G->matrix + (size_t)u * G->nV;
+    for (v++; v < G->nV; v++)
+        if (row[v] >= 0)
+            return v;
+    return -1;
+}
+
+/**
+ * @brief Set the density above which the graph uses a matrix
+ * @param G Target graph pointer
+ * @param density Threshold 2E/V² (> 0)
+ */
+void setDensityThreshold(Graph G, double density)
+{
+    if (density <= 0)
         return;
-    // Set edge weight
-    G->edges[u][v] = walkTime;
-    G->edges[v][u] = walkTime;
+    G->threshold = density;
+    G->filling = 0;
+    rebalance(G);
+}
+
+/**
+ * @brief Report the current representation and memory use
+ * @param G Graph pointer
+ * @return GraphStats Representation, size and bytes held
+ */
+GraphStats graphStats(Graph G)
+{
+    GraphStats s = {G->matrix != NULL, G->nV, G->nE, sizeof *G};
+    if (G->matrix)
+    {
+        s.bytes += (size_t)G->nV * G->nV * sizeof(int);
+    }
+    else
+    {
+        s.bytes += (size_t)G->nV * sizeof(LinkList);
+        for (int u = 0; u < G->nV; u++)
+            s.bytes += (size_t)G->adj[u].cap * sizeof(Link);
+    }
+    return s;
 }
 
 /**
@@ -85,17 +350,14 @@ void freeGraph(Graph G)
 {
     if (!G)
         return;
-    // Free each row of adjacency matrix
-    if (G->edges)
+    if (G->adj)
     {
         for (int i = 0; i < G->nV; i++)
         {
-            free(G->edges[i]);
+            free(G->adj[i].links);
         }
-        free(G->edges);
+        free(G->adj);
     }
-    // Free DFS-related arrays
-    free(G->visited);
-    free(G->parent);
+    free(G->matrix);
     free(G); // Free structure
-}
\ No newline at end of file
+}
\ No newline at end of file
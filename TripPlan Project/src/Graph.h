@@ -2,34 +2,86 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <stdbool.h>
+#include <stddef.h>
+
 /**
  * @struct GraphRep
- * @brief Adjacency matrix representation of a graph
+ * @brief Undirected weighted graph kept as sorted neighbour arrays while
+ *        sparse and as an adjacency matrix once dense (see Graph.c)
+ */
+typedef struct GraphRep *Graph;
+
+/**
+ * @struct GraphStats
+ * @brief Current representation of a graph and the heap memory it holds
  */
-typedef struct GraphRep
+typedef struct
 {
-    int nV;       // Number of vertices (landmarks) in graph
-    int *visited; // Visited marker array (0=unvisited, 1=visited)
-    int *parent;  // Predecessor array (-1 indicates no predecessor)
-    int **edges;  // adjacency matrix storing walking times between vertices
-} *Graph;
+    bool dense;   // Adjacency matrix (true) or sorted neighbour arrays (false)
+    int nV;       // Number of vertices
+    int nE;       // Number of edges
+    size_t bytes; // Heap bytes held by the graph
+} GraphStats;
 
 /**
- * @brief Create and initialize adjacency matrix graph
+ * @brief Create a graph with no edges
  * @param nV Number of vertices in graph
- * @return Graph Initialized graph pointer
+ * @return Graph Initialized graph pointer, NULL on allocation failure
  */
 Graph newGraph(int nV);
 
+/**
+ * @brief Create a graph with no edges, sized for an expected edge count
+ * @param nV Number of vertices in graph
+ * @param nE Expected number of edges (picks the starting representation,
+ *           which is kept until that many edges are in)
+ * @return Graph Initialized graph pointer, NULL on allocation failure
+ */
+Graph newGraphSized(int nV, int nE);
+
 /**
  * @brief Insert/update edge in undirected graph
  * @param G Target graph pointer
  * @param u Source vertex index
  * @param v Destination vertex index
- * @param walkTime Walking time in mins
- * @note Sets both edges[u][v] and edges[v][u]
+ * @param walkTime Walking time in mins, -1 to remove the edge
+ * @return bool false on allocation failure (graph unchanged), true otherwise
+ * @note Sets both u-v and v-u
+ */
+bool insertEdge(Graph G, int u, int v, int walkTime);
+
+/**
+ * @brief Walking time of an edge
+ * @param G Graph pointer
+ * @param u Source vertex index (0 ≤ u < nV)
+ * @param v Destination vertex index (0 ≤ v < nV)
+ * @return int Walking time in mins, -1 if u and v are not adjacent
+ */
+int edgeWeight(Graph G, int u, int v);
+
+/**
+ * @brief Next neighbour of a vertex in increasing index order
+ * @param G Graph pointer
+ * @param u Vertex index (0 ≤ u < nV)
+ * @param v Previous neighbour, or -1 for the first one
+ * @return int Lowest neighbour of u above v, -1 if none
+ */
+int nextNeighbour(Graph G, int u, int v);
+
+/**
+ * @brief Set the density 2E/V² above which the graph uses a matrix
+ * @param G Target graph pointer
+ * @param density Threshold (> 0); the graph returns to arrays below a quarter of it
+ */
+void setDensityThreshold(Graph G, double density);
+
+/**
+ * @brief Report the current representation and memory use
+ * @param G Graph pointer
+ * @return GraphStats Representation, size and bytes held
  */
-void insertEdge(Graph G, int u, int v, int walkTime);
+GraphStats graphStats(Graph G);
 
 /**
  * @brief Free memory used by graph
@@ -2,16 +2,14 @@
 #include "PQueue.h"
 #include <stdlib.h>
 
-// Global Heap definition
-HeapNode *minHeap = NULL; // Allocated heap array, stores HeapNode elements
-int minHeapSize = 0;      // Count of valid elements in current heap
-
 /**
  * @brief Internal heap up function
+ * @param h Target heap
  * @param i Node index that needs adjustment
  */
-static void heapifyUp(int i)
+static void heapifyUp(MinHeap *h, int i)
 {
+    HeapNode *minHeap = h->nodes;
     while (i > 0)
     {
         int parent = (i - 1) / 2;
@@ -27,10 +25,13 @@ static void heapifyUp(int i)
 
 /**
  * @brief Internal heap down function
+ * @param h Target heap
  * @param i Node index that needs adjustment
  */
-static void heapifyDown(int i)
+static void heapifyDown(MinHeap *h, int i)
 {
+    HeapNode *minHeap = h->nodes;
+    int minHeapSize = h->size;
     while (1)
     {
         int left = 2 * i + 1;
@@ -60,21 +61,21 @@ static void heapifyDown(int i)
     }
 }
 
-void minHeapPush(int landmarkIndex, int arrivalTime)
+void minHeapPush(MinHeap *h, int landmarkIndex, int arrivalTime)
 {
     // Add new element to the end of the heap
-    int i = minHeapSize++;
-    minHeap[i].landmarkIndex = landmarkIndex;
-    minHeap[i].arrivalTime = arrivalTime;
+    int i = h->size++;
+    h->nodes[i].landmarkIndex = landmarkIndex;
+    h->nodes[i].arrivalTime = arrivalTime;
     // Adjust upwards starting from new position
-    heapifyUp(i);
+    heapifyUp(h, i);
 }
 
-HeapNode minHeapPop(void)
+HeapNode minHeapPop(MinHeap *h)
 {
-    HeapNode top = minHeap[0]; // Store the top element of heap
+    HeapNode top = h->nodes[0]; // Store the top element of heap
     // Replace top of heap with last element
-    minHeap[0] = minHeap[--minHeapSize];
-    heapifyDown(0); // Adjust downwards starting from heap top
+    h->nodes[0] = h->nodes[--h->size];
+    heapifyDown(h, 0); // Adjust downwards starting from heap top
     return top;
 }
\ No newline at end of file
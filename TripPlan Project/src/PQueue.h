@@ -12,23 +12,32 @@ typedef struct
     int arrivalTime;   // Arrival time at the landmark (in minutes)
 } HeapNode;
 
-/*  Global heap array pointer (defined in PQueue.c) */
-extern HeapNode *minHeap; // Dynamically allocated min-heap array
-extern int minHeapSize;   // Current number of valid elements in heap
+/**
+ * @struct MinHeap
+ * @brief Min-heap storage owned by one search workspace
+ */
+typedef struct
+{
+    HeapNode *nodes; // Dynamically allocated min-heap array
+    int size;        // Current number of valid elements in heap
+    int capacity;    // Number of nodes allocated in array
+} MinHeap;
 
 /**
  * @brief Insert a new node into the min-heap
+ * @param h Target heap
  * @param landmarkIndex Index of the landmark to insert
  * @param arrivalTime Arrival time at the landmark
  * @note Automatically heapify-up after insertion to maintain heap properties
  */
-void minHeapPush(int landmarkIndex, int arrivalTime);
+void minHeapPush(MinHeap *h, int landmarkIndex, int arrivalTime);
 
 /**
  * @brief Pop out smallest element from the heap top
+ * @param h Target heap (must not be empty)
  * @return HeapNode Heap node containing the minimum arrival time
  * @note Automatically heapify-down after popping to maintain heap properties
  */
-HeapNode minHeapPop(void);
+HeapNode minHeapPop(MinHeap *h);
 
 #endif // PQUEUE_H
\ No newline at end of file
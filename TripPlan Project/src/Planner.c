@@ -0,0 +1,1002 @@
+// Planner.c
+
+/*
+The analysis considers the worst-case time complexity:
+l: the number of landmarks (vertices)
+w: the number of walking links (undirected edges)
+f: the number of ferry schedules (directed edges/events)
+
+1. Graph Initialization: Allocate l neighbour arrays -> O(l)
+(an l×l matrix instead once walking links are dense, 2w/l^2 > 1/4 -> O(l^2))
+2. Loading Walking Links: Reading w links and calling insertEdge -> O(w log l) amortised
+3. Loading Ferry Schedules: Sorting ferries by terminal and time -> O(flogf)
+Filling the timetable arrays -> O(l+f); In conclusion -> O(l+flogf)
+4. Searching Shortest‑Path: Initialize arrays -> O(l)
+Extractions from the min‑heap -> O(logl)
+Walking neighbors of every node -> O(l+w) (O(l^2) when the graph is a matrix)
+All outgoing ferries from that node (binary search to first boardable) -> O(f)
+Heap insertions for relaxations -> (w+f)logl; In conclusion -> O(l+(w+f)logl)
+DFS for pure walking -> O(l+w)
+5. The worst cases per query -> O(l+(w+f)logl), or O(l^2+(w+f)logl) when dense
+6. Arrive-by queries: one reverse search over the same edges -> same bound
+7. Walking components: union-find over walking links -> O(w α(l))
+Component reachability over ferries: one BFS per component -> O(c(c+f))
+Queries whose endpoints' components cannot connect -> O(1)
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "Planner.h"
+#include "PQueue.h"
+#include "Graph.h"
+
+/* —————————— Macro Definitions —————————— */
+#define INF 0x2f3f3f3f // Representing unreachable nodes
+
+/* —————————— Ferry Schedule Structures —————————— */
+/**
+ * @struct FerrySchedule
+ * @brief One ferry as read from input, only used while loading
+ */
+typedef struct FerrySchedule
+{
+    int depIndex; // Index of departure landmark
+    int arrIndex; // Index of arrival landmark
+    int depTime;  // Departure time in minutes
+    int arrTime;  // Arrival time in minutes
+} FerryS;
+
+/**
+ * @struct Timetable
+ * @brief Ferries bucketed by terminal as structure-of-arrays
+ * @note Connections of terminal u are indices offsets[u]..offsets[u+1]-1,
+ *       sorted by the time at that terminal. Minutes of day (< 2048) and
+ *       landmark indices (< 1024) fit in 16 bits, and all arrays share
+ *       one allocation.
+ */
+typedef struct
+{
+    int *offsets;      // Per-terminal start index (L + 1 entries)
+    uint16_t *depTime; // Departure times in minutes
+    uint16_t *arrTime; // Arrival times in minutes
+    uint16_t *other;   // Landmark at the other end of the connection
+} Timetable;
+
+/* —————————— Network Structure —————————— */
+struct TpNetwork
+{
+    /* — Landmark Info — */
+    int L;                               // Total number of landmarks
+    char (*landmarks)[TP_MAX_NAME_LEN]; // Array storing landmark names
+
+    /* — Transportation networks — */
+    Graph walkG;          // Graph representing walking connections
+    Timetable departures; // Ferries by departure landmark, sorted by depTime
+    Timetable arrivals;   // Ferries by arrival landmark, sorted by arrTime
+    int heapCapacity;     // Most heap entries one search can push
+
+    /* — Walking-component index — */
+    int *component;  // Walking component label of every landmark
+    int nComponents; // Number of walking components
+    int reachWords;  // 64-bit words per row of reach
+    uint64_t *reach; // Bit b of row a: component b reachable from a (ignoring time)
+};
+
+/* —————————— Workspace Structure —————————— */
+struct TpWorkspace
+{
+    const TpNetwork *net; // Network being searched
+    int sourceComp;       // Walking component of current query's source
+    int targetComp;       // Walking component of current query's destination
+
+    /* — Dijkstra algorithm data structures — */
+    MinHeap heap;         // Min Heap (Priority queue)
+    bool *finalized;      // Marks finalized nodes
+    int *earliestArrival; // Earliest arrival times
+    int *arrivalMode;     // 1=walk, 2=ferry for arrival
+    int *prevNode;        // Predecessor nodes in optimal path
+    int *walkDuration;    // Walk durations in mins
+    int *ferryDepartTime; // Ferry departure times in mins
+    int *ferryArriveTime; // Ferry arrival times in mins
+
+    /* — Reverse (arrive-by) search data structures — */
+    int *latestDeparture; // Latest departure times
+    int *departMode;      // 1=walk, 2=ferry for departure
+    int *nextNode;        // Successor nodes in optimal path
+
+    /* — DFS data structures — */
+    bool *visited; // Visited marker array
+    int *parent;   // Predecessor array (-1 indicates no predecessor)
+};
+
+/* —————————— Time Conversion Function —————————— */
+/**
+ * @brief Converts HHMM time string to minutes
+ * @param time Time string in HHMM format (e.g., "1230")
+ * @return Integer representing minutes
+ */
+static int HHMM_to_minutes(const char *time)
+{
+    int hours = (time[0] - '0') * 10 + (time[1] - '0');
+    int mins = (time[2] - '0') * 10 + (time[3] - '0');
+    return hours * 60 + mins;
+}
+
+/* —————————— Itinerary Building Functions —————————— */
+/**
+ * @brief Allocate an itinerary with room for nLegs legs
+ * @param nLegs Number of legs
+ * @return TpItinerary* Itinerary pointer, NULL on allocation failure
+ */
+static TpItinerary *newItinerary(int nLegs)
+{
+    TpItinerary *itin = malloc(sizeof *itin);
+    if (!itin)
+        return NULL;
+    itin->nLegs = nLegs;
+    itin->legs = malloc((nLegs > 0 ? nLegs : 1) * sizeof(TpLeg));
+    if (!itin->legs)
+    {
+        free(itin);
+        return NULL;
+    }
+    return itin;
+}
+
+/**
+ * @brief Stores one leg; walking legs hold their duration until scheduled
+ * @param leg Leg to fill
+ * @param mode Transportation mode (1=walk, 2=ferry)
+ * @param from Index of landmark the leg starts at
+ * @param to Index of landmark the leg ends at
+ * @param walk Walk duration (walking legs)
+ * @param fdep Ferry departure time (ferry legs)
+ * @param farr Ferry arrival time (ferry legs)
+ */
+static void setLeg(TpLeg *leg, int mode, int from, int to, int walk, int fdep, int farr)
+{
+    leg->mode = mode;
+    leg->from = from;
+    leg->to = to;
+    leg->depTime = (mode == TP_WALK) ? 0 : fdep;
+    leg->arrTime = (mode == TP_WALK) ? walk : farr;
+}
+
+/**
+ * @brief Assigns walking legs their times: walk as soon as the previous leg ends
+ * @param itin Itinerary whose walking legs still hold durations
+ * @param depTime Departure time from the source in minutes
+ */
+static void scheduleLegs(TpItinerary *itin, int depTime)
+{
+    int now = depTime;
+    for (int i = 0; i < itin->nLegs; i++)
+    {
+        TpLeg *leg = &itin->legs[i];
+        if (leg->mode == TP_WALK)
+        {
+            int w = leg->arrTime;
+            leg->depTime = now;
+            leg->arrTime = now + w;
+        }
+        now = leg->arrTime;
+    }
+}
+
+/* —————————— Timetable Functions —————————— */
+/**
+ * @brief Finds first ferry from terminal u departing at or after time t
+ * @param tt Departures timetable
+ * @param u Terminal landmark index
+ * @param t Earliest boarding time in minutes
+ * @return Index of first boardable connection (offsets[u+1] if none)
+ */
+static int firstBoardable(const Timetable *tt, int u, int t)
+{
+    int lo = tt->offsets[u], hi = tt->offsets[u + 1];
+    while (lo < hi) // Binary search over depTime, sorted per terminal
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (tt->depTime[mid] < t)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* —————————— Walking-Component Functions —————————— */
+/**
+ * @brief Checks whether component b can be reached from component a
+ * @param net Loaded network
+ * @param a Source walking component
+ * @param b Target walking component
+ * @return true if some walk/ferry sequence (ignoring times) connects them
+ */
+static bool compReaches(const TpNetwork *net, int a, int b)
+{
+    return (net->reach[(size_t)a * net->reachWords + b / 64] >> (b % 64)) & 1;
+}
+
+/**
+ * @brief Finds union-find root of a landmark, halving the path on the way
+ * @param uf Union-find parent array
+ * @param v Landmark index
+ * @return Root landmark index
+ */
+static int ufFind(int *uf, int v)
+{
+    while (uf[v] != v)
+    {
+        uf[v] = uf[uf[v]]; // Path halving
+        v = uf[v];
+    }
+    return v;
+}
+
+/**
+ * @brief Joins the sets of two landmarks, attaching the lower rank root
+ * @param uf Union-find parent array
+ * @param rank Union-find rank array
+ * @param a First landmark index
+ * @param b Second landmark index
+ */
+static void ufUnion(int *uf, int *rank, int a, int b)
+{
+    a = ufFind(uf, a);
+    b = ufFind(uf, b);
+    if (a == b)
+        return;
+    if (rank[a] < rank[b])
+    {
+        int tmp = a;
+        a = b;
+        b = tmp;
+    }
+    uf[b] = a;
+    if (rank[a] == rank[b])
+        rank[a]++;
+}
+
+/**
+ * @brief Labels walking components and summarises ferry links between them
+ * @param net Network with walking links and timetables loaded
+ * @param uf Union-find parent array filled while loading walking links
+ * @return true on success, false on allocation failure
+ */
+static bool buildComponentIndex(TpNetwork *net, int *uf)
+{
+    int L = net->L;
+
+    // Number the union-find roots 0..c-1
+    net->component = malloc(L * sizeof(int));
+    if (!net->component)
+        return false;
+    net->nComponents = 0;
+    for (int v = 0; v < L; v++)
+        net->component[v] = -1;
+    for (int v = 0; v < L; v++)
+    {
+        int r = ufFind(uf, v);
+        if (net->component[r] < 0)
+            net->component[r] = net->nComponents++;
+        net->component[v] = net->component[r];
+    }
+
+    int C = net->nComponents;
+    net->reachWords = (C + 63) / 64;
+    net->reach = calloc((size_t)C * net->reachWords, sizeof(uint64_t));
+    int *compOffsets = calloc(C + 1, sizeof(int));
+    int F = net->departures.offsets[L];
+    int *compTargets = malloc((F > 0 ? F : 1) * sizeof(int));
+    int *queue = malloc(C * sizeof(int));
+    bool ok = net->reach && compOffsets && compTargets && queue;
+
+    if (ok)
+    {
+        // Ferry links between components, bucketed by departure component
+        const Timetable *tt = &net->departures;
+        for (int u = 0; u < L; u++)
+            compOffsets[net->component[u] + 1] += tt->offsets[u + 1] - tt->offsets[u];
+        for (int c = 0; c < C; c++)
+            compOffsets[c + 1] += compOffsets[c];
+        int *fill = queue; // Reuse queue as per-component fill cursor
+        memcpy(fill, compOffsets, C * sizeof(int));
+        for (int u = 0; u < L; u++)
+        {
+            for (int i = tt->offsets[u]; i < tt->offsets[u + 1]; i++)
+                compTargets[fill[net->component[u]]++] = net->component[tt->other[i]];
+        }
+
+        // BFS from each component over component-level ferry links
+        for (int c = 0; c < C; c++)
+        {
+            uint64_t *row = &net->reach[(size_t)c * net->reachWords];
+            int head = 0, tail = 0;
+            row[c / 64] |= 1ULL << (c % 64);
+            queue[tail++] = c;
+            while (head < tail)
+            {
+                int a = queue[head++];
+                for (int i = compOffsets[a]; i < compOffsets[a + 1]; i++)
+                {
+                    int b = compTargets[i];
+                    if (!((row[b / 64] >> (b % 64)) & 1))
+                    {
+                        row[b / 64] |= 1ULL << (b % 64);
+                        queue[tail++] = b;
+                    }
+                }
+            }
+        }
+    }
+    free(compOffsets);
+    free(compTargets);
+    free(queue);
+    return ok;
+}
+
+/* —————————— Relaxation  Edge Function —————————— */
+/**
+ * @brief Updates the shortest path to a node if a better path is found
+ * @param ws Pointer to workspace
+ * @param from Index of source landmark
+ * @param to Index of destination landmark
+ * @param depart Departure time from source
+ * @param arrive Arrival time at destination
+ * @param mode Transportation mode (1=walk, 2=ferry)
+ */
+static void relaxEdge(TpWorkspace *ws, int from, int to, int depart, int arrive, int mode)
+{
+    // Prune nodes whose component can never lead to the destination
+    if (!compReaches(ws->net, ws->net->component[to], ws->targetComp))
+        return;
+    // Only update if node not finalized and new arrival time is better
+    if (!ws->finalized[to] && arrive < ws->earliestArrival[to])
+    {
+        ws->earliestArrival[to] = arrive; // Update best arrival time
+        ws->prevNode[to] = from;          // Update path predecessor
+        ws->arrivalMode[to] = mode;       // Record arrival method
+
+        if (mode == TP_WALK)
+        {
+            ws->walkDuration[to] = arrive - depart; // Store walk duration
+        }
+        else
+        {
+            ws->ferryDepartTime[to] = depart; // Store ferry departure time
+            ws->ferryArriveTime[to] = arrive; // Store ferry arrival time
+        }
+        minHeapPush(&ws->heap, to, arrive); // Add to PQueue for further processing
+    }
+}
+
+/* —————————— Find Shortest Route Function —————————— */
+/**
+ * @brief Finds fastest route using both walking and ferries
+ * @param ws Pointer to workspace
+ * @param src Index of source landmark
+ * @param dst Index of destination landmark
+ * @param depTime Departure time from source in minutes
+ * @param out Receives itinerary if route found
+ * @return int TP_OK, TP_NO_ROUTE or TP_ENOMEM
+ */
+static int findRoute(TpWorkspace *ws, int src, int dst, int depTime, TpItinerary **out)
+{
+    const TpNetwork *net = ws->net;
+    for (int i = 0; i < net->L; i++) // Initialize nodes
+    {
+        ws->finalized[i] = false;     // No nodes finalized yet
+        ws->earliestArrival[i] = INF; // All nodes unreachable in default
+        ws->arrivalMode[i] = 0;       // No arrival mode set
+    }
+
+    // Start with source node at departure time
+    ws->earliestArrival[src] = depTime;
+    ws->heap.size = 0; // Reset priority queue
+    minHeapPush(&ws->heap, src, depTime);
+
+    // Main algorithm loop
+    while (ws->heap.size > 0)
+    {
+        // Get node with earliest arrival time
+        HeapNode entry = minHeapPop(&ws->heap); // Pop up earliest arriving node
+        int u = entry.landmarkIndex;            // Pop up current node index
+        int t = entry.arrivalTime;              // Current node arrival time
+
+        if (ws->finalized[u])
+            continue;
+        ws->finalized[u] = true; // Marks as finalized
+
+        if (u == dst)
+            break; // Break if reached the destination
+
+        // Relax all walking edges from current node
+        for (int v = nextNeighbour(net->walkG, u, -1); v >= 0; v = nextNeighbour(net->walkG, u, v))
+        {
+            relaxEdge(ws, u, v, t, t + edgeWeight(net->walkG, u, v), TP_WALK);
+        }
+        // Relax all ferry connections from current node that depart after current time
+        const Timetable *tt = &net->departures;
+        for (int i = firstBoardable(tt, u, t); i < tt->offsets[u + 1]; i++)
+        {
+            relaxEdge(ws, u, tt->other[i], tt->depTime[i], tt->arrTime[i], TP_FERRY);
+        }
+    }
+
+    // Check if destination was reached
+    if (ws->earliestArrival[dst] == INF)
+        return TP_NO_ROUTE;
+
+    // Count legs, then backtrack from destination filling legs from the end
+    int len = 0;
+    for (int v = dst; v != src; v = ws->prevNode[v])
+        len++;
+    TpItinerary *itin = newItinerary(len);
+    if (!itin)
+        return TP_ENOMEM;
+    for (int v = dst, i = len - 1; v != src; v = ws->prevNode[v], i--)
+    {
+        setLeg(&itin->legs[i], ws->arrivalMode[v], ws->prevNode[v], v,
+               ws->walkDuration[v], ws->ferryDepartTime[v], ws->ferryArriveTime[v]);
+    }
+    scheduleLegs(itin, depTime);
+    *out = itin;
+    return TP_OK;
+}
+
+/* —————————— Reverse (Arrive-by) Search Functions —————————— */
+/**
+ * @brief Updates the latest departure from a node if a later one is found
+ * @param ws Pointer to workspace
+ * @param from Index of landmark the leg departs from
+ * @param to Index of landmark the leg arrives at
+ * @param depart Departure time from source of the leg
+ * @param arrive Arrival time at destination of the leg
+ * @param mode Transportation mode (1=walk, 2=ferry)
+ */
+static void relaxEdgeBackward(TpWorkspace *ws, int from, int to, int depart, int arrive, int mode)
+{
+    // Prune nodes whose component can never be reached from the source
+    if (!compReaches(ws->net, ws->sourceComp, ws->net->component[from]))
+        return;
+    // Only update if node not finalized and new departure time is later (same day)
+    if (!ws->finalized[from] && depart >= 0 && depart > ws->latestDeparture[from])
+    {
+        ws->latestDeparture[from] = depart; // Update best departure time
+        ws->nextNode[from] = to;            // Update path successor
+        ws->departMode[from] = mode;        // Record departure method
+
+        if (mode == TP_WALK)
+        {
+            ws->walkDuration[from] = arrive - depart; // Store walk duration
+        }
+        else
+        {
+            ws->ferryDepartTime[from] = depart; // Store ferry departure time
+            ws->ferryArriveTime[from] = arrive; // Store ferry arrival time
+        }
+        minHeapPush(&ws->heap, from, -depart); // Negated key turns min-heap into max-heap
+    }
+}
+
+/**
+ * @brief Finds latest-departure route arriving at dst no later than arriveBy
+ * @param ws Pointer to workspace
+ * @param src Index of source landmark
+ * @param dst Index of destination landmark
+ * @param arriveBy Latest acceptable arrival time in minutes
+ * @param out Receives itinerary if route found
+ * @return int TP_OK, TP_NO_ROUTE or TP_ENOMEM
+ * @note Searches backwards from dst: a ferry can be taken if it arrives
+ *       no later than the time we must be at its arrival landmark
+ */
+static int findLatestRoute(TpWorkspace *ws, int src, int dst, int arriveBy, TpItinerary **out)
+{
+    const TpNetwork *net = ws->net;
+    for (int i = 0; i < net->L; i++) // Initialize nodes
+    {
+        ws->finalized[i] = false;      // No nodes finalized yet
+        ws->latestDeparture[i] = -INF; // All nodes unreachable in default
+        ws->departMode[i] = 0;         // No departure mode set
+    }
+
+    // Start with destination node at the arrive-by time
+    ws->latestDeparture[dst] = arriveBy;
+    ws->heap.size = 0; // Reset priority queue
+    minHeapPush(&ws->heap, dst, -arriveBy);
+
+    // Main algorithm loop
+    while (ws->heap.size > 0)
+    {
+        // Get node with latest departure time
+        HeapNode entry = minHeapPop(&ws->heap);
+        int u = entry.landmarkIndex; // Current node index
+        int t = -entry.arrivalTime;  // Latest time to leave current node
+
+        if (ws->finalized[u])
+            continue;
+        ws->finalized[u] = true; // Marks as finalized
+
+        if (u == src)
+            break; // Break if reached the source
+
+        // Relax all walking edges into current node (walking graph is undirected)
+        for (int v = nextNeighbour(net->walkG, u, -1); v >= 0; v = nextNeighbour(net->walkG, u, v))
+        {
+            relaxEdgeBackward(ws, v, u, t - edgeWeight(net->walkG, v, u), t, TP_WALK);
+        }
+        // Relax all ferry connections arriving at current node in time
+        const Timetable *tt = &net->arrivals;
+        for (int i = tt->offsets[u]; i < tt->offsets[u + 1] && tt->arrTime[i] <= t; i++)
+        {
+            relaxEdgeBackward(ws, tt->other[i], u, tt->depTime[i], tt->arrTime[i], TP_FERRY);
+        }
+    }
+
+    // Check if source can reach destination in time
+    if (ws->latestDeparture[src] == -INF)
+        return TP_NO_ROUTE;
+
+    // Follow successors from source
+    int len = 0;
+    for (int v = src; v != dst; v = ws->nextNode[v])
+        len++;
+    TpItinerary *itin = newItinerary(len);
+    if (!itin)
+        return TP_ENOMEM;
+    for (int v = src, i = 0; v != dst; v = ws->nextNode[v], i++)
+    {
+        setLeg(&itin->legs[i], ws->departMode[v], v, ws->nextNode[v],
+               ws->walkDuration[v], ws->ferryDepartTime[v], ws->ferryArriveTime[v]);
+    }
+    scheduleLegs(itin, ws->latestDeparture[src]);
+    *out = itin;
+    return TP_OK;
+}
+
+/* —————————— Walking Path Search（DFS） —————————— */
+/**
+ * @brief Depth-first search to find walking path
+ * @param ws Pointer to workspace
+ * @param curV Current landmark index
+ * @param tarV Target landmark index
+ * @return true if path found, false otherwise
+ */
+static bool dfs(TpWorkspace *ws, int curV, int tarV)
+{
+    if (curV == tarV) // Base case: found target
+        return true;
+
+    ws->visited[curV] = true; // Mark current node as visited
+
+    // Go through all neighbors
+    Graph walkG = ws->net->walkG;
+    for (int nxt = nextNeighbour(walkG, curV, -1); nxt >= 0; nxt = nextNeighbour(walkG, curV, nxt))
+    {
+        if (!ws->visited[nxt])
+        {
+            ws->parent[nxt] = curV; // Records parent nodes
+            if (dfs(ws, nxt, tarV)) // Recursively search
+                return true;
+        }
+    }
+    return false; // Target not found from this path
+}
+
+/**
+ * @brief Builds itinerary for walking path found by DFS
+ * @param ws Pointer to workspace
+ * @param dst Destination landmark index
+ * @param depTime Departure time from source in minutes
+ * @return TpItinerary* Itinerary, NULL on allocation failure
+ */
+static TpItinerary *walkPathItinerary(TpWorkspace *ws, int dst, int depTime)
+{
+    int len = 0;
+    for (int cur = dst; ws->parent[cur] != -1; cur = ws->parent[cur])
+        len++;
+    TpItinerary *itin = newItinerary(len);
+    if (!itin)
+        return NULL;
+    // Reconstruct path from destination to source
+    for (int cur = dst, i = len - 1; ws->parent[cur] != -1; cur = ws->parent[cur], i--)
+    {
+        int u = ws->parent[cur];
+        setLeg(&itin->legs[i], TP_WALK, u, cur, edgeWeight(ws->net->walkG, u, cur), 0, 0);
+    }
+    scheduleLegs(itin, depTime);
+    return itin;
+}
+
+/* —————————— Data Loading Functions —————————— */
+/**
+ * @brief Loads landmark names from input
+ * @param net Pointer to network
+ * @param in Input stream
+ * @return true if all names read, false otherwise
+ */
+static bool loadLandmarks(TpNetwork *net, FILE *in)
+{
+    for (int i = 0; i < net->L; i++)
+    {
+        if (fscanf(in, "%31s", net->landmarks[i]) != 1) // Load landmark names
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Loads walking connections between landmarks
+ * @param net Pointer to network
+ * @param in Input stream
+ * @param W Number of walking links to load
+ * @param uf Union-find parent array, joined along every link
+ * @param rank Union-find rank array
+ * @return true if all links valid, false otherwise
+ */
+static bool loadWalkingLinks(TpNetwork *net, FILE *in, int W, int *uf, int *rank)
+{
+    for (int i = 0; i < W; i++)
+    {
+        char lName_a[TP_MAX_NAME_LEN], lName_b[TP_MAX_NAME_LEN];
+        int walkT;
+        if (fscanf(in, "%31s %31s %d", lName_a, lName_b, &walkT) != 3)
+            return false;
+        int idxa = tp_landmark_index(net, lName_a), idxb = tp_landmark_index(net, lName_b);
+        if (idxa < 0 || idxb < 0 || walkT < 0)
+            return false;
+        if (!insertEdge(net->walkG, idxa, idxb, walkT))
+            return false;
+        ufUnion(uf, rank, idxa, idxb);
+    }
+    return true;
+}
+
+/**
+ * @brief Orders ferries by departure landmark, then departure time
+ * @param a First ferry
+ * @param b Second ferry
+ * @return Negative, zero or positive as for qsort
+ */
+static int cmpByDeparture(const void *a, const void *b)
+{
+    const FerryS *x = a, *y = b;
+    if (x->depIndex != y->depIndex)
+        return x->depIndex - y->depIndex;
+    return x->depTime - y->depTime;
+}
+
+/**
+ * @brief Orders ferries by arrival landmark, then arrival time
+ * @param a First ferry
+ * @param b Second ferry
+ * @return Negative, zero or positive as for qsort
+ */
+static int cmpByArrival(const void *a, const void *b)
+{
+    const FerryS *x = a, *y = b;
+    if (x->arrIndex != y->arrIndex)
+        return x->arrIndex - y->arrIndex;
+    return x->arrTime - y->arrTime;
+}
+
+/**
+ * @brief Builds a timetable from ferries sorted by terminal and time
+ * @param tt Timetable to fill (arrays allocated here in one block)
+ * @param L Number of landmarks
+ * @param all Ferries sorted with cmpByDeparture or cmpByArrival
+ * @param F Number of ferries
+ * @param byArrival false to bucket by departure, true by arrival landmark
+ * @return true on success, false on allocation failure
+ */
+static bool buildTimetable(Timetable *tt, int L, const FerryS *all, int F, bool byArrival)
+{
+    // offsets[L+1] followed by three uint16_t arrays of F entries
+    char *block = malloc((L + 1) * sizeof(int) + 3 * (size_t)F * sizeof(uint16_t));
+    if (!block)
+        return false;
+    tt->offsets = (int *)block;
+    tt->depTime = (uint16_t *)(block + (L + 1) * sizeof(int));
+    tt->arrTime = tt->depTime + F;
+    tt->other = tt->arrTime + F;
+
+    // Count ferries per terminal, then prefix sums give each terminal's start
+    memset(tt->offsets, 0, (L + 1) * sizeof(int));
+    for (int i = 0; i < F; i++)
+        tt->offsets[(byArrival ? all[i].arrIndex : all[i].depIndex) + 1]++;
+    for (int u = 0; u < L; u++)
+        tt->offsets[u + 1] += tt->offsets[u];
+
+    // Input is already in terminal order, so copy fields straight across
+    for (int i = 0; i < F; i++)
+    {
+        tt->depTime[i] = (uint16_t)all[i].depTime;
+        tt->arrTime[i] = (uint16_t)all[i].arrTime;
+        tt->other[i] = (uint16_t)(byArrival ? all[i].depIndex : all[i].arrIndex);
+    }
+    return true;
+}
+
+/**
+ * @brief Loads ferry schedules between landmarks
+ * @param net Pointer to network
+ * @param in Input stream
+ * @param F Number of ferry schedules to load
+ * @return true if all schedules valid, false otherwise
+ */
+static bool loadFerrySchedules(TpNetwork *net, FILE *in, int F)
+{
+    FerryS *allferries = malloc((F > 0 ? F : 1) * sizeof *allferries);
+    if (!allferries)
+        return false;
+
+    for (int i = 0; i < F; i++)
+    {
+        char dep[TP_MAX_NAME_LEN], dept[5], arr[TP_MAX_NAME_LEN], arrt[5];
+        if (fscanf(in, "%31s %4s %31s %4s", dep, dept, arr, arrt) != 4)
+            goto fail;
+        allferries[i].depIndex = tp_landmark_index(net, dep);
+        allferries[i].arrIndex = tp_landmark_index(net, arr);
+        allferries[i].depTime = HHMM_to_minutes(dept);
+        allferries[i].arrTime = HHMM_to_minutes(arrt);
+        if (allferries[i].depIndex < 0 || allferries[i].arrIndex < 0 ||
+            allferries[i].depTime >= 24 * 60 || allferries[i].arrTime >= 24 * 60)
+            goto fail; // Timetable stores landmarks and times in 16 bits
+    }
+
+    // Ferries by departure point for forward search, by arrival for arrive-by
+    qsort(allferries, F, sizeof *allferries, cmpByDeparture);
+    if (!buildTimetable(&net->departures, net->L, allferries, F, false))
+        goto fail;
+    qsort(allferries, F, sizeof *allferries, cmpByArrival);
+    if (!buildTimetable(&net->arrivals, net->L, allferries, F, true))
+        goto fail;
+    free(allferries); // Free temporary array
+    return true;
+
+fail:
+    free(allferries);
+    return false;
+}
+
+/* —————————— Network Functions —————————— */
+TpNetwork *tp_network_load(FILE *in, FILE *prompts)
+{
+    int L, W, F;
+    int *uf = NULL, *rank = NULL;
+
+    if (prompts)
+        fprintf(prompts, "Number of landmarks: ");
+    if (fscanf(in, "%d", &L) != 1 || L <= 0 || L > TP_MAX_LANDMARKS)
+        return NULL;
+
+    // Initialize landmark count and data structures
+    TpNetwork *net = calloc(1, sizeof *net);
+    if (!net)
+        return NULL;
+    net->L = L;
+    net->landmarks = malloc(L * sizeof *net->landmarks);  // Landmark names
+    uf = malloc(L * sizeof(int));                         // Union-find over walking links
+    rank = calloc(L, sizeof(int));
+    if (!net->landmarks || !uf || !rank)
+        goto fail;
+    for (int v = 0; v < L; v++)
+        uf[v] = v; // Every landmark starts in its own component
+
+    // Load landmark data
+    if (!loadLandmarks(net, in))
+        goto fail;
+
+    // Load walking connections
+    if (prompts)
+        fprintf(prompts, "Number of walking links: ");
+    if (fscanf(in, "%d", &W) != 1 || W < 0)
+        goto fail;
+    net->walkG = newGraphSized(L, W); // Create graph for walking connections, sized for W links
+    if (!net->walkG || !loadWalkingLinks(net, in, W, uf, rank))
+        goto fail;
+
+    // Load ferry schedules
+    if (prompts)
+        fprintf(prompts, "Number of ferry schedules: ");
+    if (fscanf(in, "%d", &F) != 1 || F < 0 || !loadFerrySchedules(net, in, F))
+        goto fail;
+
+    // Label walking components and which components ferries connect
+    if (!buildComponentIndex(net, uf))
+        goto fail;
+    free(uf);
+    free(rank);
+
+    // Every relaxation pushes at most once: 1 + 2w walking + f ferry entries
+    net->heapCapacity = L + 2 * W + F + 5;
+    return net;
+
+fail:
+    free(uf);
+    free(rank);
+    tp_network_free(net);
+    return NULL;
+}
+
+void tp_network_free(TpNetwork *net)
+{
+    if (!net)
+        return;
+    // Each timetable is one block starting at its offsets array
+    free(net->departures.offsets);
+    free(net->arrivals.offsets);
+    free(net->component);
+    free(net->reach);
+    freeGraph(net->walkG); // Free graph memory
+    free(net->landmarks);
+    free(net);
+}
+
+int tp_landmark_count(const TpNetwork *net)
+{
+    return net->L;
+}
+
+int tp_landmark_index(const TpNetwork *net, const char *name)
+{
+    for (int i = 0; i < net->L; i++)
+    {
+        if (strcmp(net->landmarks[i], name) == 0)
+        {
+            return i; // Return index matches
+        }
+    }
+    return -1; // Not found
+}
+
+const char *tp_landmark_name(const TpNetwork *net, int index)
+{
+    return net->landmarks[index];
+}
+
+int tp_parse_time(const char *hhmm)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        if (!isdigit((unsigned char)hhmm[i]))
+            return -1;
+    }
+    int minutes = HHMM_to_minutes(hhmm);
+    return (hhmm[4] == '\0' && minutes < 24 * 60) ? minutes : -1;
+}
+
+/* —————————— Workspace Functions —————————— */
+TpWorkspace *tp_workspace_create(const TpNetwork *net)
+{
+    int L = net->L;
+    TpWorkspace *ws = calloc(1, sizeof *ws);
+    if (!ws)
+        return NULL;
+    ws->net = net;
+    ws->heap.capacity = net->heapCapacity;
+    ws->heap.nodes = malloc(net->heapCapacity * sizeof(HeapNode)); // Allocate priority queue
+    ws->finalized = malloc(L * sizeof(bool));
+    ws->earliestArrival = malloc(L * sizeof(int));
+    ws->arrivalMode = malloc(L * sizeof(int));
+    ws->prevNode = malloc(L * sizeof(int));
+    ws->walkDuration = malloc(L * sizeof(int));
+    ws->ferryDepartTime = malloc(L * sizeof(int));
+    ws->ferryArriveTime = malloc(L * sizeof(int));
+    ws->latestDeparture = malloc(L * sizeof(int));
+    ws->departMode = malloc(L * sizeof(int));
+    ws->nextNode = malloc(L * sizeof(int));
+    ws->visited = malloc(L * sizeof(bool));
+    ws->parent = malloc(L * sizeof(int));
+    if (!ws->heap.nodes || !ws->finalized || !ws->earliestArrival || !ws->arrivalMode ||
+        !ws->prevNode || !ws->walkDuration || !ws->ferryDepartTime || !ws->ferryArriveTime ||
+        !ws->latestDeparture || !ws->departMode || !ws->nextNode || !ws->visited || !ws->parent)
+    {
+        tp_workspace_free(ws);
+        return NULL;
+    }
+    return ws;
+}
+
+void tp_workspace_free(TpWorkspace *ws)
+{
+    if (!ws)
+        return;
+    free(ws->heap.nodes); // Free priority queue memory
+    free(ws->finalized);
+    free(ws->earliestArrival);
+    free(ws->arrivalMode);
+    free(ws->prevNode);
+    free(ws->walkDuration);
+    free(ws->ferryDepartTime);
+    free(ws->ferryArriveTime);
+    free(ws->latestDeparture);
+    free(ws->departMode);
+    free(ws->nextNode);
+    free(ws->visited);
+    free(ws->parent);
+    free(ws);
+}
+
+/* —————————— Query Functions —————————— */
+/**
+ * @brief Checks query arguments against a workspace's network
+ * @param ws Workspace
+ * @param src Index of source landmark
+ * @param dst Index of destination landmark
+ * @param time Query time in minutes
+ * @param out Output pointer
+ * @return true if valid, false otherwise
+ */
+static bool validQuery(const TpWorkspace *ws, int src, int dst, int time, TpItinerary **out)
+{
+    int L = ws->net->L;
+    return out && src >= 0 && src < L && dst >= 0 && dst < L && time >= 0 && time < 24 * 60;
+}
+
+int tp_query_earliest(TpWorkspace *ws, int src, int dst, int depTime, TpItinerary **out)
+{
+    if (!validQuery(ws, src, dst, depTime, out))
+        return TP_EINVAL;
+    const TpNetwork *net = ws->net;
+
+    // Check for direct walking connection first
+    if (edgeWeight(net->walkG, src, dst) >= 0)
+    {
+        TpItinerary *itin = newItinerary(1);
+        if (!itin)
+            return TP_ENOMEM;
+        setLeg(&itin->legs[0], TP_WALK, src, dst, edgeWeight(net->walkG, src, dst), 0, 0);
+        scheduleLegs(itin, depTime);
+        *out = itin;
+        return TP_OK;
+    }
+
+    // Endpoints in components that no ferry sequence links cannot connect
+    ws->sourceComp = net->component[src];
+    ws->targetComp = net->component[dst];
+    if (!compReaches(net, ws->sourceComp, ws->targetComp))
+        return TP_NO_ROUTE;
+
+    // Try to find mixed walking/ferry route
+    int rc = findRoute(ws, src, dst, depTime, out);
+    if (rc != TP_NO_ROUTE)
+        return rc;
+
+    // If no mixed route, try pure walking path using DFS (only possible on foot
+    // within one component)
+    if (ws->sourceComp != ws->targetComp)
+        return TP_NO_ROUTE;
+    memset(ws->visited, 0, net->L * sizeof(bool));
+    memset(ws->parent, -1, net->L * sizeof(int));
+    if (!dfs(ws, src, dst))
+        return TP_NO_ROUTE;
+    *out = walkPathItinerary(ws, dst, depTime);
+    return *out ? TP_OK : TP_ENOMEM;
+}
+
+int tp_query_latest(TpWorkspace *ws, int src, int dst, int arrTime, TpItinerary **out)
+{
+    if (!validQuery(ws, src, dst, arrTime, out))
+        return TP_EINVAL;
+    const TpNetwork *net = ws->net;
+
+    // Endpoints in components that no ferry sequence links cannot connect
+    ws->sourceComp = net->component[src];
+    ws->targetComp = net->component[dst];
+    if (!compReaches(net, ws->sourceComp, ws->targetComp))
+        return TP_NO_ROUTE;
+    return findLatestRoute(ws, src, dst, arrTime, out);
+}
+
+void tp_free(TpItinerary *itin)
+{
+    if (!itin)
+        return;
+    free(itin->legs);
+    free(itin);
+}
@@ -0,0 +1,152 @@
+// Planner.h
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include <stdio.h>
+
+/* —————————— Limits and Status Codes —————————— */
+#define TP_MAX_LANDMARKS 999 // Maximum number of landmarks
+#define TP_MAX_NAME_LEN 32   // Maximum length for landmark names (including /0)
+
+#define TP_OK 0         // Route found
+#define TP_NO_ROUTE 1   // Query was valid but no route exists
+#define TP_EINVAL (-1)  // Invalid argument (unknown landmark, bad time)
+#define TP_ENOMEM (-2)  // Memory allocation failed
+
+/**
+ * @struct TpNetwork
+ * @brief Loaded walking graph and ferry timetable (read-only once loaded)
+ * @note One network may be shared by any number of threads
+ */
+typedef struct TpNetwork TpNetwork;
+
+/**
+ * @struct TpWorkspace
+ * @brief Scratch memory for searches over one network
+ * @note A workspace must only be used by one thread at a time
+ */
+typedef struct TpWorkspace TpWorkspace;
+
+/**
+ * @enum TpMode
+ * @brief Transportation mode of an itinerary leg
+ */
+typedef enum
+{
+    TP_WALK = 1, // Walking link
+    TP_FERRY = 2 // Ferry service
+} TpMode;
+
+/**
+ * @struct TpLeg
+ * @brief One walking or ferry leg of an itinerary
+ */
+typedef struct
+{
+    TpMode mode; // Walk or ferry
+    int from;    // Index of landmark the leg starts at
+    int to;      // Index of landmark the leg ends at
+    int depTime; // Departure time in minutes after midnight
+    int arrTime; // Arrival time in minutes after midnight
+} TpLeg;
+
+/**
+ * @struct TpItinerary
+ * @brief Route from source to destination as a sequence of legs
+ */
+typedef struct
+{
+    int nLegs;   // Number of legs (0 if source equals destination)
+    TpLeg *legs; // Legs in travel order
+} TpItinerary;
+
+/* —————————— Network Functions —————————— */
+/**
+ * @brief Loads landmarks, walking links and ferry schedules
+ * @param in Stream in the tripPlan input format (queries are not read)
+ * @param prompts Stream receiving input prompts, or NULL for none
+ * @return TpNetwork* Loaded network, NULL on bad input or allocation failure
+ */
+TpNetwork *tp_network_load(FILE *in, FILE *prompts);
+
+/**
+ * @brief Free a network and everything it owns
+ * @param net Network pointer to free (NULL is ignored)
+ * @note All workspaces for the network must be freed first
+ */
+void tp_network_free(TpNetwork *net);
+
+/**
+ * @brief Number of landmarks in a network
+ * @param net Loaded network
+ * @return int Landmark count
+ */
+int tp_landmark_count(const TpNetwork *net);
+
+/**
+ * @brief Finds index of a landmark by name
+ * @param net Loaded network
+ * @param name Landmark name
+ * @return int Index of landmark or -1 if not found
+ */
+int tp_landmark_index(const TpNetwork *net, const char *name);
+
+/**
+ * @brief Name of a landmark
+ * @param net Loaded network
+ * @param index Landmark index (0 ≤ index < tp_landmark_count)
+ * @return const char* Landmark name owned by the network
+ */
+const char *tp_landmark_name(const TpNetwork *net, int index);
+
+/**
+ * @brief Converts an HHMM time string to minutes after midnight
+ * @param hhmm Time string in HHMM format (e.g., "1230")
+ * @return int Minutes, or -1 if not four digits forming a valid time
+ */
+int tp_parse_time(const char *hhmm);
+
+/* —————————— Workspace Functions —————————— */
+/**
+ * @brief Allocate search scratch memory for a network
+ * @param net Loaded network
+ * @return TpWorkspace* Workspace pointer, NULL on allocation failure
+ */
+TpWorkspace *tp_workspace_create(const TpNetwork *net);
+
+/**
+ * @brief Free a workspace
+ * @param ws Workspace pointer to free (NULL is ignored)
+ */
+void tp_workspace_free(TpWorkspace *ws);
+
+/* —————————— Query Functions —————————— */
+/**
+ * @brief Finds the earliest-arrival route leaving src at depTime
+ * @param ws Workspace for the network being searched
+ * @param src Index of source landmark
+ * @param dst Index of destination landmark
+ * @param depTime Departure time in minutes after midnight
+ * @param out Receives the itinerary on TP_OK (release with tp_free)
+ * @return int TP_OK, TP_NO_ROUTE, TP_EINVAL or TP_ENOMEM
+ */
+int tp_query_earliest(TpWorkspace *ws, int src, int dst, int depTime, TpItinerary **out);
+
+/**
+ * @brief Finds the latest-departure route arriving at dst by arrTime
+ * @param ws Workspace for the network being searched
+ * @param src Index of source landmark
+ * @param dst Index of destination landmark
+ * @param arrTime Latest arrival time in minutes after midnight
+ * @param out Receives the itinerary on TP_OK (release with tp_free)
+ * @return int TP_OK, TP_NO_ROUTE, TP_EINVAL or TP_ENOMEM
+ */
+int tp_query_latest(TpWorkspace *ws, int src, int dst, int arrTime, TpItinerary **out);
+
+/**
+ * @brief Free an itinerary returned by a query
+ * @param itin Itinerary pointer to free (NULL is ignored)
+ */
+void tp_free(TpItinerary *itin);
+
+#endif // PLANNER_H
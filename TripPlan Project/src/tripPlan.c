@@ -1,83 +1,34 @@
 // tripPlan.c
 
 /*
-The analysis considers the worst-case time complexity:
-l: the number of landmarks (vertices)
-w: the number of walking links (undirected edges)
-f: the number of ferry schedules (directed edges/events)
-
-1. Graph Initialization: Allocate and initialize l×l adjacency matrix -> O(l^2)
-2. Loading Walking Links: Reading w links and calling insertEdge -> O(w)
-3. Loading Ferry Schedules: Go through ferries per node -> O(f)
-Allocating adjacency lists -> O(f); In conclusion -> O(f)
-4. Searching Shortest‑Path: Initialize arrays -> O(l)
-Extractions from the min‑heap -> O(logl)
-All possible walking neighbors (matrix) -> O(l^2)
-All outgoing ferries from that node -> O(f)
-Heap insertions for relaxations -> (w+f)logl; In conclusion -> O(l^2+(w+f)logl)
-DFS for pure walking -> O(l^2)
-5. The worst cases per query -> O(l^2+(w+f)logl)
+Command-line client of the trip planning engine in Planner.c (see there
+for the search algorithms and their complexity). Reads the network and
+then queries from stdin, or serves queries on a Unix domain socket.
 */
 
+#define _POSIX_C_SOURCE 200809L // open_memstream, sigaction, sockets
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
-#include "PQueue.h"
-#include "Graph.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "Planner.h"
 
 /* —————————— Macro Definitions —————————— */
-#define MAX_LANDMARKS 999 // Maximum number of landmarks
-#define MAX_NAME_LEN 32   // Maximum length for landmark names (including /0)
-#define INF 0x2f3f3f3f    // Representing unreachable nodes
-
-/* —————————— Ferry Schedule Structure —————————— */
-typedef struct FerrySchedule
-{
-    int depIndex; // Index of departure landmark
-    int arrIndex; // Index of arrival landmark
-    int depTime;  // Departure time in minutes
-    int arrTime;  // Arrival time in minutes
-} FerryS;
-
-/* —————————— Global State Structure —————————— */
-typedef struct
-{
-    /* — Landmark Info — */
-    int L;                                       // Total number of landmarks
-    char landmarks[MAX_LANDMARKS][MAX_NAME_LEN]; // Array storing landmark names
-    int currentDepTime;                          // Departure time for current query
-
-    /* — Transportation networks — */
-    Graph walkG;       // Graph representing walking connections
-    int *ferryCount;   // Array counting ferries for every landmark
-    FerryS **ferryAdj; // Adjacency list for ferry schedules
-
-    /* — Dijkstra algorithm data structures — */
-    HeapNode *minHeap;                  // Min Heap (Priority queue)
-    int minHeapSize;                    // Current size of priority queue
-    bool finalized[MAX_LANDMARKS];      // Marks finalized nodes
-    int earliestArrival[MAX_LANDMARKS]; // Earliest arrival times
-    int arrivalMode[MAX_LANDMARKS];     // 1=walk, 2=ferry for arrival
-    int prevNode[MAX_LANDMARKS];        // Predecessor nodes in optimal path
-    int walkDuration[MAX_LANDMARKS];    // Walk durations in mins
-    int ferryDepartTime[MAX_LANDMARKS]; // Ferry departure times in mins
-    int ferryArriveTime[MAX_LANDMARKS]; // Ferry arrival times in mins
-} State;
-
-/* —————————— Time Conversion Functions —————————— */
-/**
- * @brief Converts HHMM time string to minutes
- * @param time Time string in HHMM format (e.g., "1230")
- * @return Integer representing minutes
- */
-static int HHMM_to_minutes(const char *time)
-{
-    int hours = (time[0] - '0') * 10 + (time[1] - '0');
-    int mins = (time[2] - '0') * 10 + (time[3] - '0');
-    return hours * 60 + mins;
-}
+#define DAEMON_WORKERS 4       // Default number of query worker threads
+#define DAEMON_BACKLOG 64      // Pending connections on the listening socket
+#define DAEMON_MAX_INFLIGHT 64 // Pipelined queries per client before reads pause
+#define DAEMON_MAX_LINE 128    // Longest accepted query line (including /0)
 
+/* —————————— Time Conversion Function —————————— */
 /**
  * @brief Converts minutes to HHMM format as integer
  * @param minutes Time in minutes
@@ -90,388 +41,692 @@ static int minutes_to_HHMM(int minutes)
     return hours * 100 + mins;
 }
 
-/* —————————— Landmark Search Function —————————— */
+/* —————————— Route Printing Function —————————— */
 /**
- * @brief Finds index of a landmark by name
- * @param st Pointer to State structure
- * @param lName Landmark name to search for
- * @return Index of landmark or -1 if not found
+ * @brief Prints an itinerary leg by leg
+ * @param net Network the itinerary was found in
+ * @param itin Itinerary to print
+ * @param out Output stream
  */
-static int getLandmark(State *st, const char *lName)
+static void printItinerary(const TpNetwork *net, const TpItinerary *itin, FILE *out)
 {
-    for (int i = 0; i < st->L; i++)
+    fprintf(out, "\n");
+    for (int i = 0; i < itin->nLegs; i++)
     {
-        if (strcmp(st->landmarks[i], lName) == 0)
-        {
-            return i; // Return index matches
-        }
+        const TpLeg *leg = &itin->legs[i];
+        fprintf(out, "%s %d minute(s):\n", leg->mode == TP_WALK ? "Walk" : "Ferry", leg->arrTime - leg->depTime);
+        fprintf(out, "  %04d %s\n", minutes_to_HHMM(leg->depTime), tp_landmark_name(net, leg->from));
+        fprintf(out, "  %04d %s\n", minutes_to_HHMM(leg->arrTime), tp_landmark_name(net, leg->to));
     }
-    return -1; // Not found
 }
 
-/* —————————— Relaxation  Edge Function —————————— */
+/* —————————— Query Handling Function —————————— */
 /**
- * @brief Updates the shortest path to a node if a better path is found
- * @param st Pointer to State structure
- * @param from Index of source landmark
- * @param to Index of destination landmark
- * @param depart Departure time from source
- * @param arrive Arrival time at destination
- * @param mode Transportation mode (1=walk, 2=ferry)
+ * @brief Handles a single route query
+ * @param ws Workspace for the loaded network
+ * @param net Loaded network
+ * @param out Output stream
+ * @param from Source landmark name
+ * @param to Destination landmark name
+ * @param HHMM Departure time (or latest arrival time) in HHMM format
+ * @param arriveBy true for latest departure arriving by HHMM
+ * @return int TP_OK and TP_NO_ROUTE are printed, other codes are not
  */
-static void relaxEdge(State *st, int from, int to, int depart, int arrive, int mode)
+static int handleQuery(TpWorkspace *ws, const TpNetwork *net, FILE *out,
+                       const char *from, const char *to, const char *HHMM, bool arriveBy)
 {
-    // Only update if node not finalized and new arrival time is better
-    if (!st->finalized[to] && arrive < st->earliestArrival[to])
-    {
-        st->earliestArrival[to] = arrive; // Update best arrival time
-        st->prevNode[to] = from;          // Update path predecessor
-        st->arrivalMode[to] = mode;       // Record arrival method
+    int src = tp_landmark_index(net, from), dst = tp_landmark_index(net, to);
+    int time = tp_parse_time(HHMM);
+    TpItinerary *itin = NULL;
 
-        if (mode == 1)
-        {
-            st->walkDuration[to] = arrive - depart; // Store walk duration
-        }
-        else
-        {
-            st->ferryDepartTime[to] = depart; // Store ferry departure time
-            st->ferryArriveTime[to] = arrive; // Store ferry arrival time
-        }
-        minHeapPush(to, arrive); // Add to PQueue for further processing
+    int rc = arriveBy ? tp_query_latest(ws, src, dst, time, &itin)
+                      : tp_query_earliest(ws, src, dst, time, &itin);
+    if (rc == TP_OK)
+    {
+        printItinerary(net, itin, out);
+        tp_free(itin);
     }
+    else if (rc == TP_NO_ROUTE)
+    {
+        fprintf(out, "\nNo route.\n");
+    }
+    return rc;
 }
 
-/* —————————— Find Shortest Route Function —————————— */
+/* —————————— Daemon Mode —————————— */
+typedef struct Client Client;
+
+/**
+ * @struct Job
+ * @brief One pipelined query and, once answered, its response text
+ */
+typedef struct Job
+{
+    Client *client;             // Connection the query arrived on
+    unsigned long seq;          // Position of the query on its connection
+    char line[DAEMON_MAX_LINE]; // Query line ("" if it was too long)
+    char *resp;                 // Response text written by a worker
+    size_t respLen;             // Response length in bytes
+    struct Job *next;           // Next job in queue or list
+} Job;
+
+/**
+ * @struct Client
+ * @brief Connection state, touched only by the event loop thread
+ */
+struct Client
+{
+    int fd;                     // Connected socket (non-blocking)
+    char in[DAEMON_MAX_LINE];   // Partial query line
+    size_t inLen;               // Bytes held in partial line
+    bool overlong;              // Discarding the rest of a too-long line
+    char *out;                  // Response bytes waiting to be written
+    size_t outLen, outOff;      // Bytes buffered / bytes already written
+    size_t outCap;              // Allocated size of out buffer
+    unsigned long nextSeq;      // Sequence number for next query read
+    unsigned long nextOut;      // Sequence number of next response to write
+    Job *ready;                 // Answered jobs sorted by seq, not yet written
+    int inflight;               // Queries read but not yet written back
+    bool eof;                   // Peer finished sending queries
+    bool dead;                  // Socket failed, drop remaining responses
+    Client *next;               // Next connection in list
+};
+
 /**
- * @brief Finds fastest route using both walking and ferries
- * @param st Pointer to State structure
- * @param src Index of source landmark
- * @param dst Index of destination landmark
- * @return true if route found, false otherwise
+ * @struct Daemon
+ * @brief State shared between the event loop and query workers
  */
-static bool findRoute(State *st, int src, int dst)
+typedef struct
 {
-    for (int i = 0; i < st->L; i++) // Initialize nodes
+    const TpNetwork *net;     // Loaded network, read-only after loading
+    pthread_mutex_t lock;     // Guards todo, done and stopping
+    pthread_cond_t more;      // Signalled when todo gains a job
+    Job *todoHead, *todoTail; // FIFO of queries waiting for a worker
+    Job *done;                // Answered jobs waiting for the event loop
+    bool stopping;            // Workers should exit
+    int wakeFd[2];            // Self-pipe used by workers to wake event loop
+} Daemon;
+
+/**
+ * @struct Worker
+ * @brief What one query worker thread is started with
+ */
+typedef struct
+{
+    Daemon *d;                // Shared daemon state
+    TpWorkspace *ws;          // Worker's own search arrays, made before it starts
+} Worker;
+
+static volatile sig_atomic_t stopRequested = 0; // Set by SIGINT/SIGTERM
+static volatile sig_atomic_t stopWakeFd = -1;   // Wake pipe write end, -1 if none
+
+/**
+ * @brief Signal handler requesting daemon shutdown
+ * @param sig Signal number (unused)
+ * @note Also writes to the wake pipe, so a signal arriving just before the
+ *       event loop blocks in poll() still wakes it
+ */
+static void onStopSignal(int sig)
+{
+    (void)sig;
+    int saved = errno;
+    stopRequested = 1;
+    if (stopWakeFd >= 0)
     {
-        st->finalized[i] = false;     // No nodes finalized yet
-        st->earliestArrival[i] = INF; // All nodes unreachable in default
-        st->arrivalMode[i] = 0;       // No arrival mode set
+        ssize_t unused = write(stopWakeFd, "", 1); // A full pipe already wakes poll()
+        (void)unused;
     }
+    errno = saved;
+}
 
-    // Start with source node at departure time
-    st->earliestArrival[src] = st->currentDepTime;
-    minHeapSize = 0; // Reset priority queue
-    minHeapPush(src, st->currentDepTime);
+/**
+ * @brief Answers one query line into the job's response buffer
+ * @param ws Worker's own workspace
+ * @param net Loaded network
+ * @param job Job holding the query line
+ * @note Lines are "<from> <to> <hhmm>", or "-a <from> <to> <hhmm>" for an
+ *       arrive-by query. Every response ends with a blank line.
+ */
+static void answerQuery(TpWorkspace *ws, const TpNetwork *net, Job *job)
+{
+    char from[TP_MAX_NAME_LEN], to[TP_MAX_NAME_LEN], HHMM[TP_MAX_NAME_LEN], extra;
+    const char *q = job->line;
+    bool arriveBy = false;
 
-    // Main algorithm loop
-    while (minHeapSize > 0)
+    if (strncmp(q, "-a ", 3) == 0)
     {
-        // Get node with earliest arrival time
-        HeapNode entry = minHeapPop(); // Pop up earliest arriving node
-        int u = entry.landmarkIndex;   // Pop up current node index
-        int t = entry.arrivalTime;     // Current node arrival time
+        arriveBy = true;
+        q += 3;
+    }
 
-        if (st->finalized[u])
-            continue;
-        st->finalized[u] = true; // Marks as finalized
+    FILE *out = open_memstream(&job->resp, &job->respLen);
+    if (!out)
+    {
+        job->resp = NULL;
+        job->respLen = 0;
+        return;
+    }
+    if (sscanf(q, "%31s %31s %31s %c", from, to, HHMM, &extra) != 3 ||
+        handleQuery(ws, net, out, from, to, HHMM, arriveBy) == TP_EINVAL)
+    {
+        fprintf(out, "\nInvalid query.\n");
+    }
+    fprintf(out, "\n"); // Blank line terminates the response
+    fclose(out);
+}
 
-        if (u == dst)
-            break; // Break if reached the destination
+/**
+ * @brief Worker thread: answers queued queries with a private workspace
+ * @param arg Pointer to Worker
+ * @return NULL
+ */
+static void *queryWorker(void *arg)
+{
+    Daemon *d = ((Worker *)arg)->d;
+    TpWorkspace *ws = ((Worker *)arg)->ws; // Share network, own the search arrays
 
-        // Relax all walking edges from current node
-        for (int v = 0; v < st->L; v++)
-        {
-            int w = st->walkG->edges[u][v];
-            if (w >= 0) // If walking connection exists
-            {
-                relaxEdge(st, u, v, t, t + w, 1); // Mode 1 = walking
-            }
-        }
-        // Relax all ferry connections from current node
-        for (int i = 0; i < st->ferryCount[u]; i++)
+    while (true)
+    {
+        pthread_mutex_lock(&d->lock);
+        while (!d->todoHead && !d->stopping)
+            pthread_cond_wait(&d->more, &d->lock);
+        if (d->stopping)
         {
-            FerryS *f = &st->ferryAdj[u][i];
-            if (f->depTime >= t) // Only consider ferries that depart after current time
-            {
-                relaxEdge(st, u, f->arrIndex, f->depTime, f->arrTime, 2); // Mode 2 = ferry
-            }
+            pthread_mutex_unlock(&d->lock);
+            break;
         }
+        Job *job = d->todoHead;
+        d->todoHead = job->next;
+        if (!d->todoHead)
+            d->todoTail = NULL;
+        pthread_mutex_unlock(&d->lock);
+
+        answerQuery(ws, d->net, job);
+
+        pthread_mutex_lock(&d->lock);
+        job->next = d->done;
+        d->done = job;
+        pthread_mutex_unlock(&d->lock);
+        if (write(d->wakeFd[1], "", 1) < 0 && errno != EAGAIN)
+            break; // Event loop is gone
     }
+    return NULL;
+}
 
-    // Check if destination was reached
-    if (st->earliestArrival[dst] == INF)
-        return false;
+/**
+ * @brief Queues a complete query line read from a client
+ * @param d Pointer to Daemon
+ * @param c Client the line came from
+ * @param line Query text (need not be terminated)
+ * @param len Length of query text
+ * @param overlong true if the line exceeded DAEMON_MAX_LINE
+ */
+static void submitLine(Daemon *d, Client *c, const char *line, size_t len, bool overlong)
+{
+    if (len > 0 && line[len - 1] == '\r')
+        len--;
+    if (len == 0 && !overlong)
+        return; // Ignore blank lines
 
-    // Reconstruct the path from destination to source
-    int routeNode[MAX_LANDMARKS]; // Nodes in the path
-    int routeMode[MAX_LANDMARKS]; // Arrival modes (1=walk, 2=ferry)
-    int routeWalk[MAX_LANDMARKS]; // Walk durations
-    int routeFdep[MAX_LANDMARKS]; // Ferry departure times
-    int routeFarr[MAX_LANDMARKS]; // Ferry arrival times
-    int len = 0;                  // Path length
+    Job *job = calloc(1, sizeof *job);
+    if (!job)
+    {
+        c->dead = true;
+        return;
+    }
+    job->client = c;
+    job->seq = c->nextSeq++;
+    if (!overlong)
+        memcpy(job->line, line, len); // Overlong lines stay "" and are rejected
+    c->inflight++;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->todoTail)
+        d->todoTail->next = job;
+    else
+        d->todoHead = job;
+    d->todoTail = job;
+    pthread_cond_signal(&d->more);
+    pthread_mutex_unlock(&d->lock);
+}
 
-    // Backtrack from destination to source
-    for (int v = dst; v != src;)
+/**
+ * @brief Reads available bytes from a client and queues complete lines
+ * @param d Pointer to Daemon
+ * @param c Client to read from
+ */
+static void readClient(Daemon *d, Client *c)
+{
+    char buf[4096];
+    ssize_t n = read(c->fd, buf, sizeof buf);
+    if (n < 0)
     {
-        routeNode[len] = v;
-        routeMode[len] = st->arrivalMode[v];
-        if (routeMode[len] == 1)
-        {
-            routeWalk[len] = st->walkDuration[v];
-            v = st->prevNode[v]; // Move to predecessor
-        }
-        else
-        {
-            routeFdep[len] = st->ferryDepartTime[v];
-            routeFarr[len] = st->ferryArriveTime[v];
-            v = st->prevNode[v]; // Move to predecessor
-        }
-        len++;
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            c->dead = true;
+        return;
     }
-    routeNode[len] = src; // Add source node
-    routeMode[len] = 0;   // No arrival mode for source
-    len++;
-
-    // Print the path (source to destination)
-    int now = st->currentDepTime;
-    printf("\n");
-    for (int i = len - 1; i > 0; i--)
+    if (n == 0)
     {
-        int u = routeNode[i], v = routeNode[i - 1];
-        if (routeMode[i - 1] == 1)
+        // Peer finished sending: an unterminated last line is still a query
+        submitLine(d, c, c->in, c->inLen, c->overlong);
+        c->inLen = 0;
+        c->overlong = false;
+        c->eof = true;
+        return;
+    }
+    for (ssize_t i = 0; i < n; i++)
+    {
+        if (buf[i] == '\n')
         {
-            // Walking segment
-            int w = routeWalk[i - 1];
-            printf("Walk %d minute(s):\n", w);
-            printf("  %04d %s\n", minutes_to_HHMM(now), st->landmarks[u]);
-            now += w;
-            printf("  %04d %s\n", minutes_to_HHMM(now), st->landmarks[v]);
+            submitLine(d, c, c->in, c->inLen, c->overlong);
+            c->inLen = 0;
+            c->overlong = false;
+        }
+        else if (c->inLen < DAEMON_MAX_LINE - 1)
+        {
+            c->in[c->inLen++] = buf[i];
         }
         else
         {
-            // Ferry segment
-            int d = routeFdep[i - 1], a = routeFarr[i - 1];
-            printf("Ferry %d minute(s):\n", a - d);
-            printf("  %04d %s\n", minutes_to_HHMM(d), st->landmarks[u]);
-            printf("  %04d %s\n", minutes_to_HHMM(a), st->landmarks[v]);
-            now = a;
+            c->overlong = true;
         }
     }
-    return true;
 }
 
-/* —————————— Walking Path Search（DFS） —————————— */
 /**
- * @brief Depth-first search to find walking path
- * @param st Pointer to State structure
- * @param curV Current landmark index
- * @param tarV Target landmark index
- * @return true if path found, false otherwise
+ * @brief Writes as much buffered response data as the socket accepts
+ * @param c Client to flush
  */
-static bool dfs(State *st, int curV, int tarV)
+static void flushClient(Client *c)
 {
-    if (curV == tarV) // Base case: found target
-        return true;
-
-    st->walkG->visited[curV] = 1; // Mark current node as visited
-
-    // Go through all neighbors
-    for (int nxt = 0; nxt < st->walkG->nV; nxt++)
+    while (!c->dead && c->outOff < c->outLen)
     {
-        if (st->walkG->edges[curV][nxt] >= 0 && !st->walkG->visited[nxt])
+        ssize_t n = write(c->fd, c->out + c->outOff, c->outLen - c->outOff);
+        if (n < 0)
         {
-            st->walkG->parent[nxt] = curV; // Records parent nodes
-            if (dfs(st, nxt, tarV))        // Recursively search
-                return true;
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                c->dead = true;
+            return;
         }
+        c->outOff += n;
     }
-    return false; // Target not found from this path
+    c->outOff = c->outLen = 0;
 }
 
 /**
- * @brief Prints walking path found by DFS
- * @param st Pointer to State structure
- * @param src Source landmark index
- * @param dst Destination landmark index
+ * @brief Appends responses that are next in sequence to the output buffer
+ * @param c Client whose ready list is drained
  */
-static void printWalkPath(State *st, int src, int dst)
+static void emitReady(Client *c)
 {
-    int path[MAX_LANDMARKS], len = 0;
-    // Reconstruct path from destination to source
-    for (int cur = dst; cur != -1; cur = st->walkG->parent[cur])
-    {
-        path[len++] = cur;
-    }
-    int curTime = st->currentDepTime;
-    printf("\n");
-    // Print every walking information
-    for (int i = 0; i < len - 1; i++)
+    while (c->ready && c->ready->seq == c->nextOut)
     {
-        int u = path[i], v = path[i + 1];
-        int walkTime = st->walkG->edges[u][v];
-        int arrTime = curTime + walkTime;
-        printf("Walk %d minute(s):\n", walkTime);
-        printf("  %04d %s\n", minutes_to_HHMM(curTime), st->landmarks[u]);
-        printf("  %04d %s\n", minutes_to_HHMM(arrTime), st->landmarks[v]);
-        curTime = arrTime;
+        Job *job = c->ready;
+        // Drop the leading blank line printed before every itinerary
+        const char *text = job->resp;
+        size_t len = job->respLen;
+        if (len > 0 && text[0] == '\n')
+        {
+            text++;
+            len--;
+        }
+        if (!c->dead && c->outLen + len > c->outCap)
+        {
+            size_t cap = c->outCap ? c->outCap : 4096;
+            while (cap < c->outLen + len)
+                cap *= 2;
+            char *out = realloc(c->out, cap);
+            if (out)
+            {
+                c->out = out;
+                c->outCap = cap;
+            }
+            else
+            {
+                c->dead = true;
+            }
+        }
+        if (!c->dead)
+        {
+            memcpy(c->out + c->outLen, text, len);
+            c->outLen += len;
+        }
+        c->ready = job->next;
+        c->nextOut++;
+        c->inflight--;
+        free(job->resp);
+        free(job);
     }
+    flushClient(c);
 }
 
-/* —————————— Data Loading Functions —————————— */
 /**
- * @brief Loads landmark names from input
- * @param st Pointer to State structure
+ * @brief Moves answered jobs from workers to their clients
+ * @param d Pointer to Daemon
  */
-static void loadLandmarks(State *st)
+static void collectDone(Daemon *d)
 {
-    for (int i = 0; i < st->L; i++)
-        scanf("%31s", st->landmarks[i]); // Load landmark names
+    char drain[256];
+    while (read(d->wakeFd[0], drain, sizeof drain) > 0)
+        ; // Empty the self-pipe
+
+    pthread_mutex_lock(&d->lock);
+    Job *job = d->done;
+    d->done = NULL;
+    pthread_mutex_unlock(&d->lock);
+
+    while (job)
+    {
+        Job *next = job->next;
+        Client *c = job->client;
+        if (!job->resp)
+        {
+            c->dead = true; // Worker could not allocate a response
+        }
+        // Insert in sequence order so pipelined responses keep query order
+        Job **pos = &c->ready;
+        while (*pos && (*pos)->seq < job->seq)
+            pos = &(*pos)->next;
+        job->next = *pos;
+        *pos = job;
+        emitReady(c);
+        job = next;
+    }
 }
 
 /**
- * @brief Loads walking connections between landmarks
- * @param st Pointer to State structure
- * @param W Number of walking links to load
+ * @brief Opens a non-blocking Unix domain socket listening on path
+ * @param path Filesystem path of the socket (replaced if it exists)
+ * @return Listening file descriptor, or -1 on failure
  */
-static void loadWalkingLinks(State *st, int W)
+static int listenUnix(const char *path)
 {
-    for (int i = 0; i < W; i++)
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof addr.sun_path)
+        return -1;
+    memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof addr) < 0 || listen(fd, DAEMON_BACKLOG) < 0 ||
+        fcntl(fd, F_SETFL, O_NONBLOCK) < 0)
     {
-        char lName_a[MAX_NAME_LEN], lName_b[MAX_NAME_LEN];
-        int walkT;
-        scanf("%31s %31s %d", lName_a, lName_b, &walkT);
-        int idxa = getLandmark(st, lName_a), idxb = getLandmark(st, lName_b);
-        insertEdge(st->walkG, idxa, idxb, walkT);
+        close(fd);
+        return -1;
     }
+    return fd;
 }
 
 /**
- * @brief Loads ferry schedules between landmarks
- * @param st Pointer to State structure
- * @param F Number of ferry schedules to load
+ * @brief Serves newline-delimited queries on a Unix domain socket
+ * @param net Loaded network
+ * @param path Filesystem path of the socket
+ * @param nWorkers Number of query worker threads
+ * @return EXIT_SUCCESS after SIGINT/SIGTERM, EXIT_FAILURE on setup error
+ * @note One poll() loop owns every connection; workers only see Jobs.
+ *       Clients may pipeline queries, responses come back in query order.
  */
-static void loadFerrySchedules(State *st, int F)
+static int runDaemon(const TpNetwork *net, const char *path, int nWorkers)
 {
-    FerryS *allferries = malloc(F * sizeof *allferries);
-
-    // Count ferries per departure point
-    for (int i = 0; i < F; i++)
+    Daemon d = {.net = net, .wakeFd = {-1, -1}};
+    pthread_t *workers = malloc(nWorkers * sizeof(pthread_t));
+    Worker *starts = calloc(nWorkers, sizeof(Worker));
+    struct pollfd *pfds = NULL;
+    Client *clients = NULL;
+    int nClients = 0, nStarted = 0, rc = EXIT_FAILURE;
+
+    int lfd = listenUnix(path);
+    if (lfd < 0)
     {
-        char dep[MAX_NAME_LEN], dept[5], arr[MAX_NAME_LEN], arrt[5];
-        scanf("%31s %4s %31s %4s", dep, dept, arr, arrt);
-        allferries[i].depIndex = getLandmark(st, dep);
-        allferries[i].arrIndex = getLandmark(st, arr);
-        allferries[i].depTime = HHMM_to_minutes(dept);
-        allferries[i].arrTime = HHMM_to_minutes(arrt);
-        st->ferryCount[allferries[i].depIndex]++;
+        fprintf(stderr, "Cannot listen on %s\n", path);
+        free(workers);
+        free(starts);
+        return EXIT_FAILURE;
     }
-
-    // Allocate ferry adjacency lists
-    for (int u = 0; u < st->L; u++)
+    if (!workers || !starts || pipe(d.wakeFd) < 0)
+        goto shutdown;
+    fcntl(d.wakeFd[0], F_SETFL, O_NONBLOCK);
+    fcntl(d.wakeFd[1], F_SETFL, O_NONBLOCK);
+
+    // Stop cleanly on SIGINT/SIGTERM, and survive clients hanging up
+    stopWakeFd = d.wakeFd[1];
+    struct sigaction sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = onStopSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    // Workers block the stop signals so only the event loop handles them
+    sigset_t stopSet, oldSet;
+    sigemptyset(&stopSet);
+    sigaddset(&stopSet, SIGINT);
+    sigaddset(&stopSet, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSet, &oldSet);
+    pthread_mutex_init(&d.lock, NULL);
+    pthread_cond_init(&d.more, NULL);
+    for (; nStarted < nWorkers; nStarted++)
+    {
+        // A worker without a workspace could never answer, so none may start short
+        starts[nStarted] = (Worker){.d = &d, .ws = tp_workspace_create(net)};
+        if (!starts[nStarted].ws)
+            break;
+        if (pthread_create(&workers[nStarted], NULL, queryWorker, &starts[nStarted]) != 0)
+        {
+            tp_workspace_free(starts[nStarted].ws);
+            break;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &oldSet, NULL);
+    if (nStarted < nWorkers)
     {
-        if (st->ferryCount[u] > 0)
-            st->ferryAdj[u] = malloc(st->ferryCount[u] * sizeof(FerryS));
-        st->ferryCount[u] = 0; // Reset counter
+        fprintf(stderr, "Cannot start %d query workers\n", nWorkers);
+        goto shutdown;
     }
 
-    // Populate ferry adjacency lists
-    for (int i = 0; i < F; i++)
+    rc = EXIT_SUCCESS;
+    while (!stopRequested)
     {
-        int u = allferries[i].depIndex;
-        st->ferryAdj[u][st->ferryCount[u]++] = allferries[i];
-    }
-    free(allferries); // Free temporary array
-}
+        // Build poll set: listener, wake pipe, then one entry per client
+        struct pollfd *grown = realloc(pfds, (nClients + 2) * sizeof *pfds);
+        if (!grown)
+        {
+            rc = EXIT_FAILURE;
+            break;
+        }
+        pfds = grown;
+        pfds[0] = (struct pollfd){.fd = lfd, .events = POLLIN};
+        pfds[1] = (struct pollfd){.fd = d.wakeFd[0], .events = POLLIN};
+        int n = 2;
+        for (Client *c = clients; c; c = c->next, n++)
+        {
+            short ev = 0;
+            if (!c->eof && c->inflight < DAEMON_MAX_INFLIGHT)
+                ev |= POLLIN; // Pause reading a client that is far ahead
+            if (c->outLen > c->outOff)
+                ev |= POLLOUT;
+            // A dead socket would report POLLHUP/POLLERR on every round
+            pfds[n] = (struct pollfd){.fd = c->dead ? -1 : c->fd, .events = ev};
+        }
 
-/* —————————— Query Handling Function —————————— */
-/**
- * @brief Handles a single route query
- * @param st Pointer to State structure
- * @param from Source landmark name
- * @param to Destination landmark name
- * @param HHMM Departure time in HHMM format
- */
-static void handleQuery(State *st, const char *from, const char *to, const char *HHMM)
-{
-    st->currentDepTime = HHMM_to_minutes(HHMM);
-    int src = getLandmark(st, from), dst = getLandmark(st, to);
+        if (poll(pfds, n, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            rc = EXIT_FAILURE;
+            break;
+        }
 
-    // Check for direct walking connection first
-    if (st->walkG->edges[src][dst] >= 0)
-    {
-        int w = st->walkG->edges[src][dst];
-        printf("\nWalk %d minute(s):\n", w);
-        printf("  %04d %s\n", minutes_to_HHMM(st->currentDepTime), from);
-        printf("  %04d %s\n", minutes_to_HHMM(st->currentDepTime + w), to);
-        return;
+        n = 2;
+        for (Client *c = clients; c; c = c->next, n++)
+        {
+            if (c->eof)
+            {
+                // Nothing more to read: a hang-up now means replies cannot be delivered
+                if (pfds[n].revents & (POLLHUP | POLLERR))
+                    c->dead = true;
+            }
+            else if (pfds[n].revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                readClient(&d, c);
+            }
+            if (pfds[n].revents & POLLOUT)
+                flushClient(c);
+        }
+        if (pfds[1].revents & POLLIN)
+            collectDone(&d);
+        if (pfds[0].revents & POLLIN)
+        {
+            int cfd;
+            while ((cfd = accept(lfd, NULL, NULL)) >= 0)
+            {
+                Client *c = calloc(1, sizeof *c);
+                if (!c || fcntl(cfd, F_SETFL, O_NONBLOCK) < 0)
+                {
+                    free(c);
+                    close(cfd);
+                    continue;
+                }
+                c->fd = cfd;
+                c->next = clients;
+                clients = c;
+                nClients++;
+            }
+        }
+
+        // Close connections that are finished or broken, once no worker holds them
+        for (Client **pc = &clients; *pc;)
+        {
+            Client *c = *pc;
+            bool finished = c->eof && c->outLen == c->outOff;
+            if (c->inflight == 0 && (c->dead || finished))
+            {
+                *pc = c->next;
+                close(c->fd);
+                free(c->out);
+                free(c);
+                nClients--;
+            }
+            else
+            {
+                pc = &c->next;
+            }
+        }
     }
 
-    // Try to find mixed walking/ferry route
-    if (findRoute(st, src, dst))
-        return;
+shutdown:
+    if (nStarted > 0)
+    {
+        pthread_mutex_lock(&d.lock);
+        d.stopping = true;
+        pthread_cond_broadcast(&d.more);
+        pthread_mutex_unlock(&d.lock);
+    }
+    for (int i = 0; i < nStarted; i++)
+    {
+        pthread_join(workers[i], NULL);
+        tp_workspace_free(starts[i].ws);
+    }
 
-    // If no mixed route, try pure walking path using DFS
-    memset(st->walkG->visited, 0, st->L * sizeof(int));
-    memset(st->walkG->parent, -1, st->L * sizeof(int));
-    if (dfs(st, src, dst))
+    // Discard queries that were never answered or written
+    for (Job *job = d.todoHead, *next; job; job = next)
     {
-        printWalkPath(st, src, dst);
+        next = job->next;
+        free(job);
     }
-    else
+    for (Job *job = d.done, *next; job; job = next)
     {
-        printf("\nNo route.\n");
+        next = job->next;
+        free(job->resp);
+        free(job);
     }
+    while (clients)
+    {
+        Client *c = clients;
+        clients = c->next;
+        for (Job *job = c->ready, *next; job; job = next)
+        {
+            next = job->next;
+            free(job->resp);
+            free(job);
+        }
+        close(c->fd);
+        free(c->out);
+        free(c);
+    }
+    if (d.wakeFd[0] >= 0)
+    {
+        stopWakeFd = -1;
+        close(d.wakeFd[0]);
+        close(d.wakeFd[1]);
+    }
+    free(pfds);
+    free(workers);
+    free(starts);
+    close(lfd);
+    unlink(path);
+    return rc;
 }
 
-/* —————————— Resource Free Function —————————— */
+/* —————————— Main Function —————————— */
 /**
- * @brief Frees all dynamically allocated memory
- * @param st Pointer to State structure
+ * @brief Program entry
+ * @note Run as "tripPlan -a" to answer arrive-by queries, where the time
+ *       entered is the latest arrival and the latest departure is returned.
+ *       Run as "tripPlan -d <socket> [-w <workers>]" to load the network
+ *       from stdin without prompts, then serve queries on a Unix socket.
  */
-static void cleanup(State *st)
-{
-    // Free ferry adjacency lists memory
-    for (int u = 0; u < st->L; u++)
-        free(st->ferryAdj[u]);
-    free(st->ferryAdj);
-    free(st->ferryCount);
-    free(minHeap);        // Free priority queue memory
-    freeGraph(st->walkG); // Free graph memory
-}
-
-/* —————————— Main Function —————————— */
-int main(void)
+int main(int argc, char *argv[])
 {
-    State st;
-    int W, F;
-
-    printf("Number of landmarks: ");
-    scanf("%d", &st.L);
+    bool arriveBy = false;
+    const char *socketPath = NULL;
+    int nWorkers = DAEMON_WORKERS;
 
-    // Initialize landmark count and data structures
-    st.walkG = newGraph(st.L);                       // Create graph for walking connections
-    st.ferryCount = calloc(st.L, sizeof(int));       // Initialize ferry counts
-    st.ferryAdj = calloc(st.L, sizeof(FerryS *));    // Allocate ferry adjacency lists
-    minHeap = malloc((st.L + 5) * sizeof(HeapNode)); // Allocate priority queue
-    minHeapSize = 0;                                 // Allocate heap size
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-a") == 0)
+            arriveBy = true;
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            socketPath = argv[++i];
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            nWorkers = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [-a] [-d socket [-w workers]]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
 
-    // Load landmark data
-    loadLandmarks(&st);
+    // Load landmarks, walking links and ferry schedules (daemon mode must not prompt)
+    TpNetwork *net = tp_network_load(stdin, socketPath ? NULL : stdout);
+    if (!net)
+    {
+        fprintf(stderr, "Invalid network input.\n");
+        return EXIT_FAILURE;
+    }
 
-    // Load walking connections
-    printf("Number of walking links: ");
-    scanf("%d", &W);
-    loadWalkingLinks(&st, W);
+    if (socketPath)
+    {
+        int rc = runDaemon(net, socketPath, nWorkers);
+        tp_network_free(net);
+        return rc;
+    }
 
-    // Load ferry schedules
-    printf("Number of ferry schedules: ");
-    scanf("%d", &F);
-    loadFerrySchedules(&st, F);
+    TpWorkspace *ws = tp_workspace_create(net);
+    if (!ws)
+    {
+        tp_network_free(net);
+        return EXIT_FAILURE;
+    }
 
     // Process queries until user enters "done"
     while (true)
     {
-        char from[MAX_NAME_LEN], to[MAX_NAME_LEN], HHMM[5];
+        char from[TP_MAX_NAME_LEN], to[TP_MAX_NAME_LEN], HHMM[5];
         printf("\nFrom: ");
         if (scanf("%31s", from) != 1 || strcmp(from, "done") == 0)
         {
@@ -480,12 +735,14 @@ int main(void)
         }
         printf("To: ");
         scanf("%31s", to);
-        printf("Departure time: ");
+        printf(arriveBy ? "Arrival time: " : "Departure time: ");
         scanf("%4s", HHMM);
-        handleQuery(&st, from, to, HHMM);
+        if (handleQuery(ws, net, stdout, from, to, HHMM, arriveBy) < 0)
+            printf("\nNo route.\n");
     }
 
     // Clean up before exiting
-    cleanup(&st);
+    tp_workspace_free(ws);
+    tp_network_free(net);
     return 0;
 }